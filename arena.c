@@ -0,0 +1,139 @@
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+struct ArenaChunk
+{
+    ArenaChunk *previous;
+    size_t used;
+    size_t size;
+    alignas(max_align_t) unsigned char data[];
+};
+
+#define ARENA_ALIGNMENT alignof(max_align_t)
+
+static ArenaChunk *arena_chunk_create(size_t size, ArenaChunk *previous)
+{
+    ArenaChunk *chunk = malloc(sizeof(ArenaChunk) + size);
+    if (!chunk)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for arena\n");
+        exit(EXIT_FAILURE);
+    }
+    chunk->previous = previous;
+    chunk->used = 0;
+    chunk->size = size;
+    return chunk;
+}
+
+Arena *arena_create(size_t chunk_size)
+{
+    Arena *arena = malloc(sizeof(Arena));
+    if (!arena)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for arena\n");
+        exit(EXIT_FAILURE);
+    }
+    arena->chunk_size = chunk_size > 0 ? chunk_size : ARENA_DEFAULT_CHUNK_SIZE;
+    arena->chunk = arena_chunk_create(arena->chunk_size, NULL);
+    arena->spare = NULL;
+    arena->attached = NULL;
+    arena->next_attached = NULL;
+    return arena;
+}
+
+static void arena_chunks_free(ArenaChunk *chunk)
+{
+    while (chunk)
+    {
+        ArenaChunk *previous = chunk->previous;
+        free(chunk);
+        chunk = previous;
+    }
+}
+
+void arena_free(Arena *arena)
+{
+    if (!arena)
+        return;
+    Arena *attached = arena->attached;
+    while (attached)
+    {
+        Arena *next = attached->next_attached;
+        arena_free(attached);
+        attached = next;
+    }
+    arena_chunks_free(arena->chunk);
+    arena_chunks_free(arena->spare);
+    free(arena);
+}
+
+void arena_attach(Arena *arena, Arena *other)
+{
+    other->next_attached = arena->attached;
+    arena->attached = other;
+}
+
+void *arena_alloc(Arena *arena, size_t size)
+{
+    // Round up so the next allocation stays aligned
+    size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+
+    ArenaChunk *chunk = arena->chunk;
+    if (chunk->size - chunk->used < size)
+    {
+        if (size <= arena->chunk_size && arena->spare)
+        {
+            // Reuse a chunk released earlier
+            chunk = arena->spare;
+            arena->spare = chunk->previous;
+            chunk->previous = arena->chunk;
+            chunk->used = 0;
+        }
+        else
+        {
+            size_t chunk_size = size > arena->chunk_size ? size : arena->chunk_size;
+            chunk = arena_chunk_create(chunk_size, arena->chunk);
+        }
+        arena->chunk = chunk;
+    }
+
+    void *memory = chunk->data + chunk->used;
+    chunk->used += size;
+    return memory;
+}
+
+char *arena_strndup(Arena *arena, const char *text, size_t length)
+{
+    char *copy = arena_alloc(arena, length + 1);
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+ArenaMark arena_mark(const Arena *arena)
+{
+    return (ArenaMark){arena->chunk, arena->chunk->used};
+}
+
+void arena_release(Arena *arena, ArenaMark mark)
+{
+    while (arena->chunk != mark.chunk)
+    {
+        ArenaChunk *chunk = arena->chunk;
+        arena->chunk = chunk->previous;
+        if (chunk->size == arena->chunk_size)
+        {
+            chunk->previous = arena->spare;
+            arena->spare = chunk;
+        }
+        else
+        {
+            free(chunk); // Oversized chunks are not reused
+        }
+    }
+    arena->chunk->used = mark.used;
+}
@@ -0,0 +1,53 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Bump-pointer arenas
+// ===================
+// An arena hands out memory from large chunks by advancing a pointer.
+// Individual allocations are never freed; the whole arena is released at
+// once, or rolled back to an earlier mark, in time proportional to the
+// number of chunks rather than the number of allocations.
+
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct Arena
+{
+    ArenaChunk *chunk;  // Chunk allocations currently come from
+    ArenaChunk *spare;  // Released chunks kept for reuse
+    size_t chunk_size;  // Usable size of a standard chunk
+    struct Arena *attached;      // Arenas freed along with this one
+    struct Arena *next_attached; // Next arena attached to the same owner
+} Arena;
+
+// A point to roll an arena back to with arena_release
+typedef struct
+{
+    ArenaChunk *chunk;
+    size_t used;
+} ArenaMark;
+
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+Arena *arena_create(size_t chunk_size);
+void arena_free(Arena *arena);
+
+// Make `arena` own `other`, so freeing `arena` frees `other` too. Both
+// stay usable; this only ties their lifetimes together, e.g. for trees
+// built on several threads that point into each other's arenas.
+void arena_attach(Arena *arena, Arena *other);
+
+// `size` bytes aligned for any object type; never returns NULL
+void *arena_alloc(Arena *arena, size_t size);
+
+// NUL-terminated copy of text[0..length)
+char *arena_strndup(Arena *arena, const char *text, size_t length);
+
+ArenaMark arena_mark(const Arena *arena);
+
+// Release everything allocated since `mark` was taken. Marks must be
+// released in the reverse order they were taken.
+void arena_release(Arena *arena, ArenaMark mark);
+
+#endif // ARENA_H
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lexer.h"
+
+// Lexer scaling benchmark
+// =======================
+// Lexes synthetic programs from 1 KB up to 100 MB and reports the cost per
+// byte at each size. A linear-time lexer keeps that cost flat; a lexer that
+// rescans its input (e.g. strlen per character) grows with the input size.
+// Exits non-zero when the per-byte cost at the largest size exceeds
+// MAX_SLOWDOWN times the cost at the reference size.
+
+#define REFERENCE_SIZE (1024 * 1024)
+#define MAX_SLOWDOWN 3.0
+
+static const char *snippet =
+    "{- generated block comment\n"
+    "   with {- a nested -} section -}\n"
+    "let add = \\ x . \\ y . (+) x y in -- curried addition\n"
+    "let total = add 40 2.5 in\n"
+    "case (==) total 42 of True -> \"yes\" ; False -> total\n";
+
+static char *generate_program(size_t size)
+{
+    char *text = malloc(size + 1);
+    if (!text)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for benchmark input\n");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t snippet_length = strlen(snippet);
+    size_t filled = 0;
+    while (filled + snippet_length <= size)
+    {
+        memcpy(text + filled, snippet, snippet_length);
+        filled += snippet_length;
+    }
+    // Pad the tail with whitespace so the input is exactly `size` bytes
+    memset(text + filled, ' ', size - filled);
+    text[size] = '\0';
+    return text;
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Returns the best-of-`runs` wall time for lexing `text` to EOF
+static double time_lexing(const char *text, size_t size, int runs, size_t *token_count)
+{
+    double best = -1.0;
+    for (int run = 0; run < runs; run++)
+    {
+        Lexer lexer = lexer_create_with_length(text, size);
+        size_t count = 0;
+        double start = now_seconds();
+        for (;;)
+        {
+            Token token = lexer_get_next_token(&lexer);
+            if (token.type == TOKEN_EOF)
+            {
+                break;
+            }
+            count++;
+        }
+        double elapsed = now_seconds() - start;
+        if (best < 0.0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+        *token_count = count;
+    }
+    return best;
+}
+
+int main(void)
+{
+    const size_t sizes[] = {
+        1024,
+        10 * 1024,
+        100 * 1024,
+        1024 * 1024,
+        10 * 1024 * 1024,
+        100 * 1024 * 1024,
+    };
+    const int size_count = sizeof(sizes) / sizeof(sizes[0]);
+
+    double reference_ns_per_byte = 0.0;
+    double largest_ns_per_byte = 0.0;
+
+    printf("%12s %12s %12s %12s\n", "bytes", "tokens", "seconds", "ns/byte");
+    for (int i = 0; i < size_count; i++)
+    {
+        size_t size = sizes[i];
+        char *text = generate_program(size);
+        // Repeat small inputs so the timer resolution does not dominate
+        int runs = size < REFERENCE_SIZE ? 50 : 3;
+        size_t tokens = 0;
+        double seconds = time_lexing(text, size, runs, &tokens);
+        double ns_per_byte = seconds * 1e9 / (double)size;
+        printf("%12zu %12zu %12.6f %12.3f\n", size, tokens, seconds, ns_per_byte);
+
+        if (size == REFERENCE_SIZE)
+        {
+            reference_ns_per_byte = ns_per_byte;
+        }
+        largest_ns_per_byte = ns_per_byte;
+        free(text);
+    }
+
+    double slowdown = largest_ns_per_byte / reference_ns_per_byte;
+    printf("\nPer-byte cost at %zu bytes is %.2fx the cost at %d bytes\n",
+           sizes[size_count - 1], slowdown, REFERENCE_SIZE);
+    if (slowdown > MAX_SLOWDOWN)
+    {
+        printf("FAIL: lexing time grows faster than linearly\n");
+        return EXIT_FAILURE;
+    }
+    printf("PASS: lexing time grows linearly\n");
+    return EXIT_SUCCESS;
+}
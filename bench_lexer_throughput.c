@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lexer.h"
+
+// Lexer throughput benchmark
+// ==========================
+// Lexes synthetic programs that each stress one part of the lexer and
+// reports MB/s and tokens/s for lexer_get_next_token. Run it before and
+// after a lexer change to compare the two objectively.
+
+#define INPUT_SIZE (16 * 1024 * 1024)
+#define RUNS 5
+
+typedef struct
+{
+    const char *name;
+    void (*append)(char *text, size_t *filled, size_t size, unsigned *seed);
+} Workload;
+
+static void append_text(char *text, size_t *filled, size_t size, const char *piece)
+{
+    size_t length = strlen(piece);
+    if (*filled + length > size)
+    {
+        length = size - *filled;
+    }
+    memcpy(text + *filled, piece, length);
+    *filled += length;
+}
+
+// Small deterministic generator, so every run lexes the same input
+static unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return (*seed >> 16) & 0x7fff;
+}
+
+// Many distinct identifiers and keywords
+static void append_identifiers(char *text, size_t *filled, size_t size, unsigned *seed)
+{
+    static const char *const keywords[] = {"let", "in", "case", "of", "fun", "if", "then", "else", "end"};
+    char piece[64];
+    if (next_random(seed) % 4 == 0)
+    {
+        snprintf(piece, sizeof(piece), "%s ", keywords[next_random(seed) % 9]);
+    }
+    else
+    {
+        snprintf(piece, sizeof(piece), "value_%u%s", next_random(seed) % 5000, next_random(seed) % 8 ? " " : "\n");
+    }
+    append_text(text, filled, size, piece);
+}
+
+// Mostly block and line comments with a little code, in the style of
+// examples/comment_syntax_showcase.lang
+static void append_comments(char *text, size_t *filled, size_t size, unsigned *seed)
+{
+    static const char *const blocks[] = {
+        "{-\n   Comment Syntax Showcase\n   =====================\n\n"
+        "   1. GHC Haskell Compatibility\n      - Use exact same comment syntax as GHC Haskell\n"
+        "      - Support nested multi-line comments\n-}\n",
+        "-- SINGLE-LINE COMMENTS:\n-- ====================\n\n",
+        "let value1 = 10 in    -- Comments can follow code on same line\n"
+        "-- Comments can also be on their own lines\n  value1              -- Expected result: 10\nend\n",
+        "{- MULTI-LINE COMMENTS:\n   Can span several lines {- and nest -} freely\n-}\n",
+        "let result = {- inline comment -} 42 in result\n",
+    };
+    append_text(text, filled, size, blocks[next_random(seed) % 5]);
+}
+
+// Integer and decimal literals of varying length
+static void append_numbers(char *text, size_t *filled, size_t size, unsigned *seed)
+{
+    char piece[64];
+    switch (next_random(seed) % 3)
+    {
+    case 0:
+        snprintf(piece, sizeof(piece), "%u ", next_random(seed));
+        break;
+    case 1:
+        snprintf(piece, sizeof(piece), "%u.%u ", next_random(seed) % 1000, next_random(seed));
+        break;
+    default:
+        snprintf(piece, sizeof(piece), "%u%u%u\n", next_random(seed), next_random(seed), next_random(seed));
+        break;
+    }
+    append_text(text, filled, size, piece);
+}
+
+// Block comments nested up to 32 deep, with a token between them
+static void append_nested_comments(char *text, size_t *filled, size_t size, unsigned *seed)
+{
+    int depth = 1 + next_random(seed) % 32;
+    for (int i = 0; i < depth; i++)
+    {
+        append_text(text, filled, size, "{- level - text {\n");
+    }
+    for (int i = 0; i < depth; i++)
+    {
+        append_text(text, filled, size, " closing -}");
+    }
+    append_text(text, filled, size, " x\n");
+}
+
+static const Workload workloads[] = {
+    {"identifiers", append_identifiers},
+    {"comments", append_comments},
+    {"numbers", append_numbers},
+    {"nested-comments", append_nested_comments},
+};
+
+static char *generate_program(const Workload *workload, size_t size)
+{
+    char *text = malloc(size + 1);
+    if (!text)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for benchmark input\n");
+        exit(EXIT_FAILURE);
+    }
+
+    unsigned seed = 42;
+    size_t filled = 0;
+    while (filled < size)
+    {
+        workload->append(text, &filled, size, &seed);
+    }
+    text[size] = '\0';
+    return text;
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Returns the best-of-RUNS wall time for lexing `text` to EOF
+static double time_lexing(const char *text, size_t size, size_t *token_count)
+{
+    double best = -1.0;
+    for (int run = 0; run < RUNS; run++)
+    {
+        Lexer lexer = lexer_create_with_length(text, size);
+        size_t count = 0;
+        double start = now_seconds();
+        for (;;)
+        {
+            Token token = lexer_get_next_token(&lexer);
+            if (token.type == TOKEN_EOF)
+            {
+                break;
+            }
+            count++;
+        }
+        double elapsed = now_seconds() - start;
+        if (best < 0.0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+        *token_count = count;
+    }
+    return best;
+}
+
+int main(void)
+{
+    const int workload_count = sizeof(workloads) / sizeof(workloads[0]);
+
+    printf("%-16s %12s %12s %12s %14s\n", "workload", "bytes", "tokens", "MB/s", "Mtokens/s");
+    for (int i = 0; i < workload_count; i++)
+    {
+        char *text = generate_program(&workloads[i], INPUT_SIZE);
+        size_t tokens = 0;
+        double seconds = time_lexing(text, INPUT_SIZE, &tokens);
+        printf("%-16s %12d %12zu %12.1f %14.2f\n", workloads[i].name, INPUT_SIZE, tokens,
+               INPUT_SIZE / seconds / 1e6, tokens / seconds / 1e6);
+        free(text);
+    }
+    return EXIT_SUCCESS;
+}
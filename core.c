@@ -1,3 +1,5 @@
+#include <inttypes.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,54 +10,123 @@
 // Core Expression Creation Functions
 // ============================================================================
 
+typedef enum {
+    CORE_SHARED_VAR,
+    CORE_SHARED_LIT,
+    CORE_SHARED_BIND,
+    CORE_SHARED_EXPR
+} CoreSharedKind;
+
+static void *core_share(CoreSharedKind kind, void *node, ArenaMark mark);
+
 CoreExpr *core_expr_create_var(CoreVar *var) {
-    CoreExpr *expr = (CoreExpr *)malloc(sizeof(CoreExpr));
+    ArenaMark mark = arena_mark(core_arena());
+    CoreExpr *expr = core_alloc(sizeof(CoreExpr));
     expr->expr_type = CORE_VAR;
     expr->var = var;
-    return expr;
+    return core_share(CORE_SHARED_EXPR, expr, mark);
 }
 
 CoreExpr *core_expr_create_lit(CoreLit *lit) {
-    CoreExpr *expr = (CoreExpr *)malloc(sizeof(CoreExpr));
+    ArenaMark mark = arena_mark(core_arena());
+    CoreExpr *expr = core_alloc(sizeof(CoreExpr));
     expr->expr_type = CORE_LIT;
     expr->lit = lit;
-    return expr;
+    return core_share(CORE_SHARED_EXPR, expr, mark);
 }
 
 CoreExpr *core_expr_create_app(CoreExpr *fun, CoreExpr *arg) {
-    CoreExpr *expr = (CoreExpr *)malloc(sizeof(CoreExpr));
+    ArenaMark mark = arena_mark(core_arena());
+    CoreExpr *expr = core_alloc(sizeof(CoreExpr));
     expr->expr_type = CORE_APP;
     expr->app.fun = fun;
     expr->app.arg = arg;
-    return expr;
+    return core_share(CORE_SHARED_EXPR, expr, mark);
 }
 
 CoreExpr *core_expr_create_lam(CoreVar *var, CoreExpr *body) {
-    CoreExpr *expr = (CoreExpr *)malloc(sizeof(CoreExpr));
+    ArenaMark mark = arena_mark(core_arena());
+    CoreExpr *expr = core_alloc(sizeof(CoreExpr));
     expr->expr_type = CORE_LAM;
     expr->lam.var = var;
     expr->lam.body = body;
-    return expr;
+    expr->lam.lazy = NULL;
+    expr->lam.pending = NULL;
+    return core_share(CORE_SHARED_EXPR, expr, mark);
 }
 
-CoreExpr *core_expr_create_let(CoreBind **binds, int bind_count, CoreExpr *body, int is_recursive) {
-    CoreExpr *expr = (CoreExpr *)malloc(sizeof(CoreExpr));
+static CoreExpr *core_lazy_lam(CoreVar *var, CoreLazyBody *lazy, struct CoreLazySubst *pending) {
+    ArenaMark mark = arena_mark(core_arena());
+    CoreExpr *expr = core_alloc(sizeof(CoreExpr));
+    expr->expr_type = CORE_LAM;
+    expr->lam.var = var;
+    expr->lam.body = NULL;
+    expr->lam.lazy = lazy;
+    expr->lam.pending = pending;
+    return core_share(CORE_SHARED_EXPR, expr, mark);
+}
+
+CoreExpr *core_expr_create_lazy_lam(CoreVar *var, CoreLazyBody *lazy) {
+    return core_lazy_lam(var, lazy, NULL);
+}
+
+// Whatever was allocated since `mark` is released along with the node if
+// an equal let is already shared
+static CoreExpr *core_let_create(CoreBind **binds, int bind_count, CoreExpr *body, int is_recursive,
+                                 ArenaMark mark) {
+    CoreExpr *expr = core_alloc(sizeof(CoreExpr));
     expr->expr_type = CORE_LET;
     expr->let.binds = binds;
     expr->let.bind_count = bind_count;
     expr->let.body = body;
     expr->let.is_recursive = is_recursive;
-    return expr;
+    return core_share(CORE_SHARED_EXPR, expr, mark);
+}
+
+CoreExpr *core_expr_create_let(CoreBind **binds, int bind_count, CoreExpr *body, int is_recursive) {
+    return core_let_create(binds, bind_count, body, is_recursive, arena_mark(core_arena()));
+}
+
+// Covers the ids from the smallest to the largest constructor in the
+// alternatives; a repeated constructor keeps its first alternative
+static CoreCaseTable *core_case_table_create(CoreAlt **alts, int alt_count) {
+    int min_id = -1, max_id = -1, default_alt = -1;
+    for (int i = 0; i < alt_count; i++) {
+        if (alts[i]->alt_kind == ALT_CON) {
+            int id = alts[i]->con.id;
+            if (min_id < 0 || id < min_id) min_id = id;
+            if (id > max_id) max_id = id;
+        } else if (alts[i]->alt_kind == ALT_DEFAULT && default_alt < 0) {
+            default_alt = i;
+        }
+    }
+    
+    int count = min_id < 0 ? 0 : max_id - min_id + 1;
+    CoreCaseTable *table = core_alloc(sizeof(CoreCaseTable) + count * sizeof(int));
+    table->base = min_id < 0 ? 0 : min_id;
+    table->count = count;
+    table->default_alt = default_alt;
+    for (int i = 0; i < count; i++) {
+        table->alt_index[i] = -1;
+    }
+    for (int i = 0; i < alt_count; i++) {
+        if (alts[i]->alt_kind == ALT_CON && table->alt_index[alts[i]->con.id - table->base] < 0) {
+            table->alt_index[alts[i]->con.id - table->base] = i;
+        }
+    }
+    return table;
 }
 
+// Never shared: each case owns its alternatives and dispatch table
 CoreExpr *core_expr_create_case(CoreExpr *expr_val, CoreVar *var, CoreType *type, CoreAlt **alts, int alt_count) {
-    CoreExpr *expr = (CoreExpr *)malloc(sizeof(CoreExpr));
+    CoreExpr *expr = core_alloc(sizeof(CoreExpr));
     expr->expr_type = CORE_CASE;
     expr->case_expr.expr = expr_val;
     expr->case_expr.var = var;
     expr->case_expr.type = type;
     expr->case_expr.alts = alts;
     expr->case_expr.alt_count = alt_count;
+    expr->case_expr.table = core_case_table_create(alts, alt_count);
     return expr;
 }
 
@@ -63,46 +134,64 @@ CoreExpr *core_expr_create_case(CoreExpr *expr_val, CoreVar *var, CoreType *type
 // Core Helper Structure Creation Functions
 // ============================================================================
 
-CoreVar *core_var_create(char *name, CoreType *type, int var_kind) {
-    CoreVar *var = (CoreVar *)malloc(sizeof(CoreVar));
-    var->name = strdup(name);
+CoreVar *core_var_create(const char *name, CoreType *type, int var_kind) {
+    return core_var_create_symbol(symbol_intern_cstr(name), type, var_kind);
+}
+
+CoreVar *core_var_create_symbol(Symbol name, CoreType *type, int var_kind) {
+    ArenaMark mark = arena_mark(core_arena());
+    CoreVar *var = core_alloc(sizeof(CoreVar));
+    var->name = name;
     var->type = type;
     var->var_kind = var_kind;
-    return var;
+    return core_share(CORE_SHARED_VAR, var, mark);
 }
 
-CoreLit *core_lit_create_int(int val) {
-    CoreLit *lit = (CoreLit *)malloc(sizeof(CoreLit));
+CoreLit *core_lit_create_int(int64_t val) {
+    ArenaMark mark = arena_mark(core_arena());
+    CoreLit *lit = core_alloc(sizeof(CoreLit));
     lit->lit_kind = LIT_INT;
     lit->int_val = val;
-    return lit;
+    return core_share(CORE_SHARED_LIT, lit, mark);
 }
 
 CoreLit *core_lit_create_double(double val) {
-    CoreLit *lit = (CoreLit *)malloc(sizeof(CoreLit));
+    ArenaMark mark = arena_mark(core_arena());
+    CoreLit *lit = core_alloc(sizeof(CoreLit));
     lit->lit_kind = LIT_DOUBLE;
     lit->double_val = val;
-    return lit;
+    return core_share(CORE_SHARED_LIT, lit, mark);
 }
 
 CoreLit *core_lit_create_string(char *val) {
-    CoreLit *lit = (CoreLit *)malloc(sizeof(CoreLit));
+    return core_lit_create_string_n(val, strlen(val));
+}
+
+CoreLit *core_lit_create_string_n(const char *val, size_t length) {
+    ArenaMark mark = arena_mark(core_arena());
+    CoreLit *lit = core_alloc(sizeof(CoreLit));
     lit->lit_kind = LIT_STRING;
-    lit->string_val = strdup(val);
-    return lit;
+    lit->string_val = arena_strndup(core_arena(), val, length);
+    return core_share(CORE_SHARED_LIT, lit, mark);
 }
 
 CoreBind *core_bind_create(CoreVar *var, CoreExpr *expr) {
-    CoreBind *bind = (CoreBind *)malloc(sizeof(CoreBind));
+    ArenaMark mark = arena_mark(core_arena());
+    CoreBind *bind = core_alloc(sizeof(CoreBind));
     bind->var = var;
     bind->expr = expr;
-    return bind;
+    return core_share(CORE_SHARED_BIND, bind, mark);
+}
+
+CoreAlt *core_alt_create_con(const char *constructor, CoreVar **vars, int var_count, CoreExpr *expr) {
+    return core_alt_create_con_symbol(symbol_intern_cstr(constructor), vars, var_count, expr);
 }
 
-CoreAlt *core_alt_create_con(char *constructor, CoreVar **vars, int var_count, CoreExpr *expr) {
-    CoreAlt *alt = (CoreAlt *)malloc(sizeof(CoreAlt));
+CoreAlt *core_alt_create_con_symbol(Symbol constructor, CoreVar **vars, int var_count, CoreExpr *expr) {
+    CoreAlt *alt = core_alloc(sizeof(CoreAlt));
     alt->alt_kind = ALT_CON;
-    alt->con.constructor = strdup(constructor);
+    alt->con.constructor = constructor;
+    alt->con.id = core_constructor_id(constructor);
     alt->con.vars = vars;
     alt->con.var_count = var_count;
     alt->expr = expr;
@@ -110,134 +199,308 @@ CoreAlt *core_alt_create_con(char *constructor, CoreVar **vars, int var_count, C
 }
 
 CoreAlt *core_alt_create_default(CoreExpr *expr) {
-    CoreAlt *alt = (CoreAlt *)malloc(sizeof(CoreAlt));
+    CoreAlt *alt = core_alloc(sizeof(CoreAlt));
     alt->alt_kind = ALT_DEFAULT;
     alt->expr = expr;
     return alt;
 }
 
 // ============================================================================
-// Core Memory Management Functions
+// Core Node Allocation
 // ============================================================================
 
-void core_expr_free(CoreExpr *expr) {
-    if (!expr) return;
-    
-    switch (expr->expr_type) {
-        case CORE_VAR:
-            core_var_free(expr->var);
-            break;
-        case CORE_LIT:
-            core_lit_free(expr->lit);
-            break;
-        case CORE_APP:
-            core_expr_free(expr->app.fun);
-            core_expr_free(expr->app.arg);
-            break;
-        case CORE_LAM:
-            core_var_free(expr->lam.var);
-            core_expr_free(expr->lam.body);
-            break;
-        case CORE_LET:
-            for (int i = 0; i < expr->let.bind_count; i++) {
-                core_bind_free(expr->let.binds[i]);
+// Current arena of this thread, and the fallback used when none is set
+static _Thread_local Arena *core_current_arena = NULL;
+static _Thread_local Arena *core_default_arena = NULL;
+
+Arena *core_arena_swap(Arena *arena) {
+    Arena *previous = core_current_arena;
+    core_current_arena = arena;
+    return previous;
+}
+
+Arena *core_arena(void) {
+    if (core_current_arena) {
+        return core_current_arena;
+    }
+    if (!core_default_arena) {
+        core_default_arena = arena_create(ARENA_DEFAULT_CHUNK_SIZE);
+    }
+    return core_default_arena;
+}
+
+void *core_alloc(size_t size) {
+    return arena_alloc(core_arena(), size);
+}
+
+// ============================================================================
+// Hash-Consing
+// ============================================================================
+
+typedef struct {
+    const void *node;       // NULL for an empty slot
+    uint64_t hash;
+    CoreSharedKind kind;
+} CoreShareEntry;
+
+// Open-addressed set of shared nodes, at most half full
+struct CoreShareTable {
+    CoreShareEntry *entries;
+    size_t capacity;        // Power of two
+    size_t count;
+};
+
+#define CORE_SHARE_INITIAL_CAPACITY 1024
+
+static _Thread_local CoreShareTable *core_current_share = NULL;
+
+static void *core_share_calloc(size_t count, size_t size) {
+    void *memory = calloc(count, size);
+    if (!memory) {
+        fprintf(stderr, "Error: Memory allocation failed for hash-consing table\n");
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+CoreShareTable *core_share_create(void) {
+    CoreShareTable *table = core_share_calloc(1, sizeof(CoreShareTable));
+    table->capacity = CORE_SHARE_INITIAL_CAPACITY;
+    table->entries = core_share_calloc(table->capacity, sizeof(CoreShareEntry));
+    return table;
+}
+
+void core_share_free(CoreShareTable *table) {
+    if (!table) return;
+    free(table->entries);
+    free(table);
+}
+
+CoreShareTable *core_share_swap(CoreShareTable *table) {
+    CoreShareTable *previous = core_current_share;
+    core_current_share = table;
+    return previous;
+}
+
+static uint64_t core_share_mix(uint64_t hash, uint64_t value) {
+    hash = (hash ^ value) * UINT64_C(0x100000001b3);
+    return hash ^ (hash >> 29);
+}
+
+// Children are shared before their parents, so a node is hashed and
+// compared shallowly: its child pointers stand for whole subtrees
+static uint64_t core_shared_hash(CoreSharedKind kind, const void *node) {
+    uint64_t hash = core_share_mix(UINT64_C(0xcbf29ce484222325), kind);
+    switch (kind) {
+        case CORE_SHARED_VAR: {
+            const CoreVar *var = node;
+            hash = core_share_mix(hash, var->name);
+            hash = core_share_mix(hash, (uintptr_t)var->type);
+            return core_share_mix(hash, var->var_kind);
+        }
+        case CORE_SHARED_LIT: {
+            const CoreLit *lit = node;
+            hash = core_share_mix(hash, lit->lit_kind);
+            switch (lit->lit_kind) {
+                case LIT_INT:
+                    return core_share_mix(hash, (uint64_t)lit->int_val);
+                case LIT_DOUBLE: {
+                    uint64_t bits;
+                    memcpy(&bits, &lit->double_val, sizeof(bits));
+                    return core_share_mix(hash, bits);
+                }
+                case LIT_STRING:
+                    for (const char *c = lit->string_val; *c; c++) {
+                        hash = core_share_mix(hash, (unsigned char)*c);
+                    }
+                    return hash;
+                case LIT_CHAR:
+                    return core_share_mix(hash, (unsigned char)lit->char_val);
             }
-            free(expr->let.binds);
-            core_expr_free(expr->let.body);
-            break;
-        case CORE_CASE:
-            core_expr_free(expr->case_expr.expr);
-            core_var_free(expr->case_expr.var);
-            core_type_free(expr->case_expr.type);
-            for (int i = 0; i < expr->case_expr.alt_count; i++) {
-                core_alt_free(expr->case_expr.alts[i]);
+            return hash;
+        }
+        case CORE_SHARED_BIND: {
+            const CoreBind *bind = node;
+            hash = core_share_mix(hash, (uintptr_t)bind->var);
+            return core_share_mix(hash, (uintptr_t)bind->expr);
+        }
+        case CORE_SHARED_EXPR: {
+            const CoreExpr *expr = node;
+            hash = core_share_mix(hash, expr->expr_type);
+            switch (expr->expr_type) {
+                case CORE_VAR:
+                    return core_share_mix(hash, (uintptr_t)expr->var);
+                case CORE_LIT:
+                    return core_share_mix(hash, (uintptr_t)expr->lit);
+                case CORE_APP:
+                    hash = core_share_mix(hash, (uintptr_t)expr->app.fun);
+                    return core_share_mix(hash, (uintptr_t)expr->app.arg);
+                case CORE_LAM:
+                    hash = core_share_mix(hash, (uintptr_t)expr->lam.var);
+                    hash = core_share_mix(hash, (uintptr_t)expr->lam.lazy);
+                    hash = core_share_mix(hash, (uintptr_t)expr->lam.pending);
+                    return core_share_mix(hash, (uintptr_t)expr->lam.body);
+                case CORE_LET:
+                    for (int i = 0; i < expr->let.bind_count; i++) {
+                        hash = core_share_mix(hash, (uintptr_t)expr->let.binds[i]);
+                    }
+                    hash = core_share_mix(hash, (uintptr_t)expr->let.body);
+                    return core_share_mix(hash, expr->let.is_recursive);
+                default:
+                    return hash;
             }
-            free(expr->case_expr.alts);
-            break;
-        case CORE_CAST:
-            core_expr_free(expr->cast.expr);
-            core_type_free(expr->cast.from_type);
-            core_type_free(expr->cast.to_type);
-            break;
-        case CORE_TICK:
-            free(expr->tick.tick_info);
-            core_expr_free(expr->tick.expr);
-            break;
-        case CORE_TYPE:
-            core_type_free(expr->type);
-            break;
-        case CORE_COERCION:
-            core_type_free(expr->coercion.from_type);
-            core_type_free(expr->coercion.to_type);
-            break;
+        }
     }
-    free(expr);
+    return hash;
 }
 
-void core_type_free(CoreType *type) {
-    if (!type) return;
-    
-    switch (type->kind) {
-        case CORE_TYPE_VAR:
-            free(type->var_name);
-            break;
-        case CORE_TYPE_CON:
-            free(type->con_name);
-            break;
-        case CORE_TYPE_APP:
-            core_type_free(type->app.fun);
-            core_type_free(type->app.arg);
-            break;
-        case CORE_TYPE_FORALL:
-            free(type->forall.var);
-            core_type_free(type->forall.body);
-            break;
+static int core_shared_equal(CoreSharedKind kind, const void *left, const void *right) {
+    switch (kind) {
+        case CORE_SHARED_VAR: {
+            const CoreVar *a = left, *b = right;
+            return a->name == b->name && a->type == b->type && a->var_kind == b->var_kind;
+        }
+        case CORE_SHARED_LIT: {
+            const CoreLit *a = left, *b = right;
+            if (a->lit_kind != b->lit_kind) return 0;
+            switch (a->lit_kind) {
+                case LIT_INT: return a->int_val == b->int_val;
+                // Bitwise, so 0.0 and -0.0 stay distinct
+                case LIT_DOUBLE: return memcmp(&a->double_val, &b->double_val, sizeof(double)) == 0;
+                case LIT_STRING: return strcmp(a->string_val, b->string_val) == 0;
+                case LIT_CHAR: return a->char_val == b->char_val;
+            }
+            return 0;
+        }
+        case CORE_SHARED_BIND: {
+            const CoreBind *a = left, *b = right;
+            return a->var == b->var && a->expr == b->expr;
+        }
+        case CORE_SHARED_EXPR: {
+            const CoreExpr *a = left, *b = right;
+            if (a->expr_type != b->expr_type) return 0;
+            switch (a->expr_type) {
+                case CORE_VAR: return a->var == b->var;
+                case CORE_LIT: return a->lit == b->lit;
+                case CORE_APP: return a->app.fun == b->app.fun && a->app.arg == b->app.arg;
+                case CORE_LAM:
+                    return a->lam.var == b->lam.var && a->lam.body == b->lam.body &&
+                           a->lam.lazy == b->lam.lazy && a->lam.pending == b->lam.pending;
+                case CORE_LET:
+                    if (a->let.bind_count != b->let.bind_count || a->let.body != b->let.body ||
+                        a->let.is_recursive != b->let.is_recursive) {
+                        return 0;
+                    }
+                    for (int i = 0; i < a->let.bind_count; i++) {
+                        if (a->let.binds[i] != b->let.binds[i]) return 0;
+                    }
+                    return 1;
+                default:
+                    return 0;
+            }
+        }
     }
-    free(type);
+    return 0;
 }
 
-void core_var_free(CoreVar *var) {
-    if (!var) return;
-    free(var->name);
-    core_type_free(var->type);
-    free(var);
+static void core_share_grow(CoreShareTable *table) {
+    size_t capacity = table->capacity * 2;
+    CoreShareEntry *entries = core_share_calloc(capacity, sizeof(CoreShareEntry));
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (!table->entries[i].node) continue;
+        size_t slot = table->entries[i].hash & (capacity - 1);
+        while (entries[slot].node) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        entries[slot] = table->entries[i];
+    }
+    free(table->entries);
+    table->entries = entries;
+    table->capacity = capacity;
 }
 
-void core_lit_free(CoreLit *lit) {
-    if (!lit) return;
-    if (lit->lit_kind == LIT_STRING) {
-        free(lit->string_val);
+// Return the shared node equal to `node`, rolling the arena back to
+// `mark` to drop `node` when one exists; otherwise `node` becomes the
+// shared one. Without a current table every node is kept as built.
+static void *core_share(CoreSharedKind kind, void *node, ArenaMark mark) {
+    CoreShareTable *table = core_current_share;
+    if (!table) {
+        return node;
+    }
+    
+    uint64_t hash = core_shared_hash(kind, node);
+    size_t slot = hash & (table->capacity - 1);
+    while (table->entries[slot].node) {
+        const CoreShareEntry *entry = &table->entries[slot];
+        if (entry->hash == hash && entry->kind == kind && core_shared_equal(kind, entry->node, node)) {
+            arena_release(core_arena(), mark);
+            return (void *)entry->node;
+        }
+        slot = (slot + 1) & (table->capacity - 1);
     }
-    free(lit);
+    
+    table->entries[slot] = (CoreShareEntry){node, hash, kind};
+    if (2 * ++table->count > table->capacity) {
+        core_share_grow(table);
+    }
+    return node;
 }
 
-void core_bind_free(CoreBind *bind) {
-    if (!bind) return;
-    core_var_free(bind->var);
-    core_expr_free(bind->expr);
-    free(bind);
+// ============================================================================
+// Lazy Lambda Bodies
+// ============================================================================
+
+// A substitution into a lazy body made before the body was parsed. The
+// pending list is newest first; applying it oldest first once the body
+// exists builds the tree the substitutions would have built eagerly.
+typedef struct CoreLazySubst {
+    Symbol var;
+    int is_number;              // From core_substitute_simple
+    CoreNumber value;
+    CoreExpr *replacement;      // From core_substitute_expr
+    struct CoreLazySubst *next;
+} CoreLazySubst;
+
+// Lazy lambda with one more pending substitution, given either a number
+// or a replacement expression
+static CoreExpr *core_lazy_substitute(CoreExpr *lam, Symbol var_name, const CoreNumber *value, CoreExpr *replacement) {
+    CoreLazySubst *subst = core_alloc(sizeof(CoreLazySubst));
+    subst->var = var_name;
+    subst->is_number = value != NULL;
+    if (value) subst->value = *value;
+    subst->replacement = replacement;
+    subst->next = lam->lam.pending;
+    return core_lazy_lam(lam->lam.var, lam->lam.lazy, subst);
 }
 
-void core_alt_free(CoreAlt *alt) {
-    if (!alt) return;
+CoreExpr *core_lam_body(CoreExpr *lam) {
+    CoreLazyBody *lazy = lam->lam.lazy;
+    if (!lazy) return lam->lam.body;
     
-    switch (alt->alt_kind) {
-        case ALT_CON:
-            free(alt->con.constructor);
-            for (int i = 0; i < alt->con.var_count; i++) {
-                core_var_free(alt->con.vars[i]);
-            }
-            free(alt->con.vars);
-            break;
-        case ALT_LIT:
-            core_lit_free(alt->lit);
-            break;
-        case ALT_DEFAULT:
-            // Nothing extra to free
-            break;
+    if (!lazy->body) {
+        // Parsed once, into the arena of the tree it belongs to. A share
+        // table only holds nodes of the arena it was used with.
+        Arena *arena = core_arena();
+        CoreShareTable *table = lazy->arena != arena ? core_share_swap(NULL) : NULL;
+        core_arena_swap(lazy->arena);
+        lazy->body = parse_core_lazy_body(lazy);
+        core_arena_swap(arena);
+        if (table) core_share_swap(table);
     }
-    core_expr_free(alt->expr);
-    free(alt);
+    
+    int count = 0;
+    for (CoreLazySubst *subst = lam->lam.pending; subst; subst = subst->next) count++;
+    if (count == 0) return lazy->body;
+    
+    CoreLazySubst **order = core_alloc(count * sizeof(CoreLazySubst *));
+    int i = count;
+    for (CoreLazySubst *subst = lam->lam.pending; subst; subst = subst->next) order[--i] = subst;
+    CoreExpr *body = lazy->body;
+    for (i = 0; i < count; i++) {
+        body = order[i]->is_number ? core_substitute_simple(body, order[i]->var, order[i]->value) :
+            core_substitute_expr(body, order[i]->var, order[i]->replacement);
+    }
+    return body;
 }
 
 // ============================================================================
@@ -279,13 +542,13 @@ void core_expr_print(CoreExpr *expr, int indent) {
     switch (expr->expr_type) {
         case CORE_VAR:
             print_indent(indent + 1);
-            printf("name: %s\n", expr->var->name);
+            printf("name: %s\n", symbol_name(expr->var->name));
             break;
         case CORE_LIT:
             print_indent(indent + 1);
             switch (expr->lit->lit_kind) {
                 case LIT_INT:
-                    printf("int: %d\n", expr->lit->int_val);
+                    printf("int: %" PRId64 "\n", expr->lit->int_val);
                     break;
                 case LIT_DOUBLE:
                     printf("double: %f\n", expr->lit->double_val);
@@ -308,10 +571,10 @@ void core_expr_print(CoreExpr *expr, int indent) {
             break;
         case CORE_LAM:
             print_indent(indent + 1);
-            printf("var: %s\n", expr->lam.var->name);
+            printf("var: %s\n", symbol_name(expr->lam.var->name));
             print_indent(indent + 1);
             printf("body:\n");
-            core_expr_print(expr->lam.body, indent + 2);
+            core_expr_print(core_lam_body(expr), indent + 2);
             break;
         case CORE_LET:
             print_indent(indent + 1);
@@ -320,7 +583,7 @@ void core_expr_print(CoreExpr *expr, int indent) {
             printf("bindings (%d):\n", expr->let.bind_count);
             for (int i = 0; i < expr->let.bind_count; i++) {
                 print_indent(indent + 2);
-                printf("%s =\n", expr->let.binds[i]->var->name);
+                printf("%s =\n", symbol_name(expr->let.binds[i]->var->name));
                 core_expr_print(expr->let.binds[i]->expr, indent + 3);
             }
             print_indent(indent + 1);
@@ -338,7 +601,7 @@ void core_expr_print(CoreExpr *expr, int indent) {
                 CoreAlt *alt = expr->case_expr.alts[i];
                 switch (alt->alt_kind) {
                     case ALT_CON:
-                        printf("%s ->", alt->con.constructor);
+                        printf("%s ->", symbol_name(alt->con.constructor));
                         break;
                     case ALT_DEFAULT:
                         printf("_ ->");
@@ -362,12 +625,17 @@ void core_expr_print(CoreExpr *expr, int indent) {
 // Core Expression Builder Utilities
 // ============================================================================
 
-CoreExpr *core_var(char *name) {
+CoreExpr *core_var(const char *name) {
     CoreVar *var = core_var_create(name, NULL, VAR_LOCAL);
     return core_expr_create_var(var);
 }
 
-CoreExpr *core_int(int val) {
+CoreExpr *core_var_symbol(Symbol name) {
+    CoreVar *var = core_var_create_symbol(name, NULL, VAR_LOCAL);
+    return core_expr_create_var(var);
+}
+
+CoreExpr *core_int(int64_t val) {
     CoreLit *lit = core_lit_create_int(val);
     return core_expr_create_lit(lit);
 }
@@ -398,6 +666,11 @@ CoreExpr *core_lambda(char *var_name, CoreExpr *body) {
     return core_expr_create_lam(var, body);
 }
 
+CoreExpr *core_lambda_symbol(Symbol var_name, CoreExpr *body) {
+    CoreVar *var = core_var_create_symbol(var_name, NULL, VAR_LOCAL);
+    return core_expr_create_lam(var, body);
+}
+
 CoreExpr *core_lambda2(char *var1, char *var2, CoreExpr *body) {
     CoreVar *v2 = core_var_create(var2, NULL, VAR_LOCAL);
     CoreExpr *inner_lam = core_expr_create_lam(v2, body);
@@ -405,26 +678,188 @@ CoreExpr *core_lambda2(char *var1, char *var2, CoreExpr *body) {
     return core_expr_create_lam(v1, inner_lam);
 }
 
-CoreExpr *core_let_simple(char *var_name, CoreExpr *value, CoreExpr *body) {
-    CoreVar *var = core_var_create(var_name, NULL, VAR_LOCAL);
+CoreExpr *core_let_var(CoreVar *var, CoreExpr *value, CoreExpr *body, int is_recursive) {
     CoreBind *bind = core_bind_create(var, value);
-    CoreBind **binds = (CoreBind **)malloc(sizeof(CoreBind *));
+    // The array belongs to the let alone, so it goes if the let is shared
+    ArenaMark mark = arena_mark(core_arena());
+    CoreBind **binds = (CoreBind **)core_alloc(sizeof(CoreBind *));
     binds[0] = bind;
-    return core_expr_create_let(binds, 1, body, 0);
+    return core_let_create(binds, 1, body, is_recursive, mark);
+}
+
+CoreExpr *core_let_simple(char *var_name, CoreExpr *value, CoreExpr *body) {
+    CoreVar *var = core_var_create(var_name, NULL, VAR_LOCAL);
+    return core_let_var(var, value, body, 0);
+}
+
+CoreExpr *core_let_symbol(Symbol var_name, CoreExpr *value, CoreExpr *body) {
+    CoreVar *var = core_var_create_symbol(var_name, NULL, VAR_LOCAL);
+    return core_let_var(var, value, body, 0);
 }
 
 CoreExpr *core_letrec_simple(char *var_name, CoreExpr *value, CoreExpr *body) {
     CoreVar *var = core_var_create(var_name, NULL, VAR_LOCAL);
-    CoreBind *bind = core_bind_create(var, value);
-    CoreBind **binds = (CoreBind **)malloc(sizeof(CoreBind *));
-    binds[0] = bind;
-    return core_expr_create_let(binds, 1, body, 1);
+    return core_let_var(var, value, body, 1);
 }
 
 CoreExpr *core_case_simple(CoreExpr *expr, CoreAlt **alts, int alt_count) {
     return core_expr_create_case(expr, NULL, NULL, alts, alt_count);
 }
 
+// ============================================================================
+// Constructors
+// ============================================================================
+
+// Primitive types every program can use without declaring them,
+// declared before any program's own types
+static const struct {
+    const char *type;
+    int tag;
+    const char *name;
+    int arity;
+    const char *fields[2];
+} builtin_constructors[] = {
+    {"Bool", 0, "False", 0, {NULL}},
+    {"Bool", 1, "True", 0, {NULL}},
+    {"Maybe", 0, "Nothing", 0, {NULL}},
+    {"Maybe", 1, "Just", 1, {"a"}},
+};
+
+// Descriptors in order of declaration, and constructor_by_symbol[symbol]
+// for every constructor name and primitive name, or NULL
+static CoreConstructor **constructors = NULL;
+static int constructor_count = 0;
+static int constructor_capacity = 0;
+static const CoreConstructor **constructor_by_symbol = NULL;
+static Symbol constructor_symbol_capacity = 0;
+static int builtin_constructors_declared = 0;
+
+static void *core_constructor_realloc(void *memory, size_t size) {
+    memory = realloc(memory, size);
+    if (!memory) {
+        fprintf(stderr, "Error: Memory allocation failed for constructor table\n");
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+static void core_constructor_map(Symbol symbol, const CoreConstructor *constructor) {
+    if (symbol >= constructor_symbol_capacity) {
+        Symbol capacity = constructor_symbol_capacity ? constructor_symbol_capacity : 64;
+        while (capacity <= symbol) {
+            capacity *= 2;
+        }
+        constructor_by_symbol = core_constructor_realloc(constructor_by_symbol, capacity * sizeof(CoreConstructor *));
+        for (Symbol i = constructor_symbol_capacity; i < capacity; i++) {
+            constructor_by_symbol[i] = NULL;
+        }
+        constructor_symbol_capacity = capacity;
+    }
+    constructor_by_symbol[symbol] = constructor;
+}
+
+static const CoreConstructor *core_constructor_find(Symbol symbol) {
+    return symbol < constructor_symbol_capacity ? constructor_by_symbol[symbol] : NULL;
+}
+
+static CoreConstructor *core_constructor_add(Symbol name) {
+    if (constructor_count == constructor_capacity) {
+        constructor_capacity = constructor_capacity ? constructor_capacity * 2 : 16;
+        constructors = core_constructor_realloc(constructors, constructor_capacity * sizeof(CoreConstructor *));
+    }
+    CoreConstructor *constructor = core_constructor_realloc(NULL, sizeof(CoreConstructor));
+    memset(constructor, 0, sizeof(CoreConstructor));
+    constructor->id = constructor_count;
+    constructor->name = name;
+    constructor->primitive = SYMBOL_NONE;
+    constructors[constructor_count++] = constructor;
+    core_constructor_map(name, constructor);
+    return constructor;
+}
+
+static void core_constructor_declare_builtins(void) {
+    if (builtin_constructors_declared) return;
+    builtin_constructors_declared = 1;
+    
+    int count = sizeof(builtin_constructors) / sizeof(builtin_constructors[0]);
+    for (int i = 0; i < count; i++) {
+        Symbol fields[2];
+        for (int j = 0; j < builtin_constructors[i].arity; j++) {
+            fields[j] = symbol_intern_cstr(builtin_constructors[i].fields[j]);
+        }
+        core_constructor_declare(symbol_intern_cstr(builtin_constructors[i].type), builtin_constructors[i].tag,
+                                 symbol_intern_cstr(builtin_constructors[i].name),
+                                 fields, builtin_constructors[i].arity);
+    }
+}
+
+const CoreConstructor *core_constructor_declare(Symbol type, int tag, Symbol name, const Symbol *fields, int arity) {
+    core_constructor_declare_builtins();
+    
+    CoreConstructor *constructor = (CoreConstructor *)core_constructor_find(name);
+    if (!constructor || constructor->name != name) {
+        constructor = core_constructor_add(name);
+    }
+    free(constructor->fields);
+    constructor->type = type;
+    constructor->tag = tag;
+    constructor->arity = arity;
+    constructor->fields = core_constructor_realloc(NULL, (arity > 0 ? arity : 1) * sizeof(Symbol));
+    if (arity > 0) {
+        memcpy(constructor->fields, fields, arity * sizeof(Symbol));
+    }
+    
+    if (constructor->primitive == SYMBOL_NONE) {
+        const char *text = symbol_name(name);
+        size_t length = strlen(text);
+        char *primitive = core_constructor_realloc(NULL, length + 2);
+        memcpy(primitive, text, length);
+        primitive[length] = '#';
+        primitive[length + 1] = '\0';
+        constructor->primitive = symbol_intern(primitive, length + 1);
+        free(primitive);
+        core_constructor_map(constructor->primitive, constructor);
+    }
+    return constructor;
+}
+
+const CoreConstructor *core_constructor_lookup(Symbol symbol) {
+    core_constructor_declare_builtins();
+    return core_constructor_find(symbol);
+}
+
+int core_constructor_count(void) {
+    core_constructor_declare_builtins();
+    return constructor_count;
+}
+
+const CoreConstructor *core_constructor_at(int index) {
+    return constructors[index];
+}
+
+int core_constructor_id(Symbol constructor) {
+    const CoreConstructor *found = core_constructor_lookup(constructor);
+    if (found) {
+        return found->id;
+    }
+    CoreConstructor *undeclared = core_constructor_add(constructor);
+    undeclared->type = SYMBOL_NONE;
+    undeclared->arity = CORE_ARITY_UNKNOWN;
+    return undeclared->id;
+}
+
+CoreAlt *core_case_lookup(CoreExpr *expr, Symbol constructor) {
+    const CoreCaseTable *table = expr->case_expr.table;
+    const CoreConstructor *found = core_constructor_lookup(constructor);
+    if (found) {
+        int index = found->id - table->base;
+        if (index >= 0 && index < table->count && table->alt_index[index] >= 0) {
+            return expr->case_expr.alts[table->alt_index[index]];
+        }
+    }
+    return table->default_alt >= 0 ? expr->case_expr.alts[table->default_alt] : NULL;
+}
+
 // ============================================================================
 // Core Expression Analysis
 // ============================================================================
@@ -444,14 +879,14 @@ int core_expr_is_value(CoreExpr *expr) {
     }
 }
 
-char *core_expr_get_var_name(CoreExpr *expr) {
+const char *core_expr_get_var_name(CoreExpr *expr) {
     if (!expr || expr->expr_type != CORE_VAR) return NULL;
-    return expr->var->name;
+    return symbol_name(expr->var->name);
 }
 
 int core_expr_count_lambdas(CoreExpr *expr) {
     if (!expr || expr->expr_type != CORE_LAM) return 0;
-    return 1 + core_expr_count_lambdas(expr->lam.body);
+    return 1 + core_expr_count_lambdas(core_lam_body(expr));
 }
 
 // ============================================================================
@@ -516,7 +951,7 @@ CoreExpr *ast_to_core(ASTNode *ast) {
             CoreExpr *else_expr = ast_to_core(ast->if_expr.else_branch);
             
             // Create alternatives
-            CoreAlt **alts = (CoreAlt **)malloc(2 * sizeof(CoreAlt *));
+            CoreAlt **alts = (CoreAlt **)core_alloc(2 * sizeof(CoreAlt *));
             alts[0] = core_alt_create_con("True", NULL, 0, then_expr);
             alts[1] = core_alt_create_con("False", NULL, 0, else_expr);
             
@@ -563,38 +998,46 @@ CoreExpr *core_expr_simplify(CoreExpr *expr) {
 // Variable checking utilities
 // ============================================================================
 
-int core_expr_contains_var(CoreExpr *expr, char *var_name) {
+int core_expr_contains_var(CoreExpr *expr, Symbol var_name) {
+    return core_expr_contains_var_tokens(expr, var_name, NULL);
+}
+
+int core_expr_contains_var_tokens(CoreExpr *expr, Symbol var_name, const TokenBuffer *tokens) {
     if (!expr) return 0;
     
     switch (expr->expr_type) {
         case CORE_VAR:
-            return strcmp(expr->var->name, var_name) == 0;
+            return expr->var->name == var_name;
             
         case CORE_LIT:
             return 0;
             
         case CORE_APP:
-            return core_expr_contains_var(expr->app.fun, var_name) ||
-                   core_expr_contains_var(expr->app.arg, var_name);
+            return core_expr_contains_var_tokens(expr->app.fun, var_name, tokens) ||
+                   core_expr_contains_var_tokens(expr->app.arg, var_name, tokens);
                    
         case CORE_LAM:
             // Don't check inside lambda if parameter shadows the variable
-            if (strcmp(expr->lam.var->name, var_name) == 0) {
+            if (expr->lam.var->name == var_name) {
                 return 0;
             }
-            return core_expr_contains_var(expr->lam.body, var_name);
+            if (expr->lam.lazy && !expr->lam.lazy->body && !expr->lam.pending) {
+                // Scan its tokens rather than parse a body that may never be needed
+                return parse_core_lazy_mentions(expr->lam.lazy, tokens, var_name);
+            }
+            return core_expr_contains_var_tokens(core_lam_body(expr), var_name, tokens);
             
         case CORE_LET:
             // Check in both binding and body
-            return core_expr_contains_var(expr->let.binds[0]->expr, var_name) ||
-                   core_expr_contains_var(expr->let.body, var_name);
+            return core_expr_contains_var_tokens(expr->let.binds[0]->expr, var_name, tokens) ||
+                   core_expr_contains_var_tokens(expr->let.body, var_name, tokens);
                    
         case CORE_CASE:
-            if (core_expr_contains_var(expr->case_expr.expr, var_name)) {
+            if (core_expr_contains_var_tokens(expr->case_expr.expr, var_name, tokens)) {
                 return 1;
             }
             for (int i = 0; i < expr->case_expr.alt_count; i++) {
-                if (core_expr_contains_var(expr->case_expr.alts[i]->expr, var_name)) {
+                if (core_expr_contains_var_tokens(expr->case_expr.alts[i]->expr, var_name, tokens)) {
                     return 1;
                 }
             }
@@ -609,12 +1052,250 @@ int core_expr_contains_var(CoreExpr *expr, char *var_name) {
 // Simple Core Evaluator (for basic expressions)
 // ============================================================================
 
+static CoreNumber core_number_int(int64_t value) {
+    CoreNumber number;
+    number.is_int = 1;
+    number.int_val = value;
+    return number;
+}
+
+static CoreNumber core_number_double(double value) {
+    CoreNumber number;
+    number.is_int = 0;
+    number.double_val = value;
+    return number;
+}
+
+double core_number_to_double(CoreNumber number) {
+    return number.is_int ? (double)number.int_val : number.double_val;
+}
+
+static void core_number_write(FILE *out, CoreNumber number) {
+    if (number.is_int) {
+        fprintf(out, "%" PRId64 ".000000", number.int_val);
+    } else {
+        fprintf(out, "%f", number.double_val);
+    }
+}
+
+void core_number_print(CoreNumber number) {
+    core_number_write(stdout, number);
+}
+
+static int core_number_is_zero(CoreNumber number) {
+    return number.is_int ? number.int_val == 0 : number.double_val == 0.0;
+}
+
+static int core_number_equal(CoreNumber left, CoreNumber right) {
+    if (left.is_int && right.is_int) {
+        return left.int_val == right.int_val;
+    }
+    return core_number_to_double(left) == core_number_to_double(right);
+}
+
+// Apply +, -, * or /. Two integers use checked integer instructions and
+// only fall back to doubles on overflow or a division with a remainder.
+static CoreNumber core_number_arith(Symbol op, CoreNumber left, CoreNumber right) {
+    if (op == SYM_DIV && core_number_is_zero(right)) {
+        fprintf(stderr, "Error: Division by zero\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    if (left.is_int && right.is_int) {
+        int64_t a = left.int_val;
+        int64_t b = right.int_val;
+        int64_t result;
+        switch (op) {
+            case SYM_PLUS:
+                if (!__builtin_add_overflow(a, b, &result)) return core_number_int(result);
+                break;
+            case SYM_MINUS:
+                if (!__builtin_sub_overflow(a, b, &result)) return core_number_int(result);
+                break;
+            case SYM_MUL:
+                if (!__builtin_mul_overflow(a, b, &result)) return core_number_int(result);
+                break;
+            case SYM_DIV:
+                // INT64_MIN / -1 is the one quotient that overflows
+                if (!(a == INT64_MIN && b == -1) && a % b == 0) return core_number_int(a / b);
+                break;
+        }
+    }
+    
+    double a = core_number_to_double(left);
+    double b = core_number_to_double(right);
+    switch (op) {
+        case SYM_PLUS: return core_number_double(a + b);
+        case SYM_MINUS: return core_number_double(a - b);
+        case SYM_MUL: return core_number_double(a * b);
+        default: return core_number_double(a / b);
+    }
+}
+
+static CoreExpr *core_number_literal(CoreNumber number) {
+    return number.is_int ? core_int(number.int_val) : core_double(number.double_val);
+}
+
+// Constructor that `expr` builds: a constructor applied to zero or more
+// fields, possibly through wrappers such as (\x. Just# x) 10. NULL if
+// `expr` is anything else.
+static const CoreConstructor *core_constructor_of(CoreExpr *expr) {
+    int arg_count = 0;
+    for (;;) {
+        while (expr->expr_type == CORE_APP) {
+            expr = expr->app.fun;
+            arg_count++;
+        }
+        if (expr->expr_type != CORE_LAM || arg_count == 0) break;
+        expr = core_lam_body(expr);
+        arg_count--;
+    }
+    return expr->expr_type == CORE_VAR ? core_constructor_lookup(expr->var->name) : NULL;
+}
+
+static int core_is_constructor_value(CoreExpr *expr) {
+    return core_constructor_of(expr) != NULL;
+}
+
+// Apply the wrappers around a constructor value, leaving the constructor
+// itself at the head: (\x. Just# x) 10 becomes Just# 10. Arguments are
+// substituted unevaluated.
+static CoreExpr *core_constructor_reduce(CoreExpr *expr) {
+    for (;;) {
+        int arg_count = 0;
+        CoreExpr *head = expr;
+        while (head->expr_type == CORE_APP) {
+            head = head->app.fun;
+            arg_count++;
+        }
+        if (head->expr_type != CORE_LAM || arg_count == 0) {
+            return expr;
+        }
+        
+        CoreExpr **args = (CoreExpr **)core_alloc(arg_count * sizeof(CoreExpr *));
+        CoreExpr *node = expr;
+        for (int i = arg_count - 1; i >= 0; i--, node = node->app.fun) {
+            args[i] = node->app.arg;
+        }
+        expr = core_substitute_expr(core_lam_body(head), head->lam.var->name, args[0]);
+        for (int i = 1; i < arg_count; i++) {
+            expr = core_expr_create_app(expr, args[i]);
+        }
+    }
+}
+
+// Declared constructor at the head of `expr` (after any applications),
+// with the number of fields it is applied to
+static const CoreConstructor *core_constructor_applied(CoreExpr *expr, int *arg_count) {
+    *arg_count = 0;
+    while (expr->expr_type == CORE_APP) {
+        expr = expr->app.fun;
+        (*arg_count)++;
+    }
+    if (expr->expr_type != CORE_VAR) return NULL;
+    const CoreConstructor *constructor = core_constructor_lookup(expr->var->name);
+    return constructor && constructor->arity != CORE_ARITY_UNKNOWN ? constructor : NULL;
+}
+
+static void core_write_value(FILE *out, CoreExpr *expr, int indent);
+
+// The constructor value evaluation ended in, as core_eval_constructor
+// wrote it, or NULL
+static char *constructor_result = NULL;
+
+// Evaluate an operand, which must be a number rather than a constructor
+static CoreNumber core_eval_operand(CoreExpr *expr) {
+    CoreNumber number = core_eval_number(expr);
+    if (constructor_result) {
+        fprintf(stderr, "Error: A constructor value cannot be used as a number\n");
+        exit(EXIT_FAILURE);
+    }
+    return number;
+}
+
+// Write a saturated constructor application as Name, or
+//   Name (
+//     field,
+//     field
+//   )
+static void core_write_constructor(FILE *out, CoreExpr *expr, const CoreConstructor *constructor, int arg_count,
+                                   int indent) {
+    if (arg_count != constructor->arity) {
+        fprintf(stderr, "Error: Constructor '%s' expects %d argument%s but got %d\n",
+                symbol_name(constructor->name), constructor->arity,
+                constructor->arity == 1 ? "" : "s", arg_count);
+        exit(EXIT_FAILURE);
+    }
+    fprintf(out, "%s", symbol_name(constructor->name));
+    if (arg_count == 0) return;
+    
+    CoreExpr **fields = (CoreExpr **)core_alloc(arg_count * sizeof(CoreExpr *));
+    for (int i = arg_count - 1; i >= 0; i--, expr = expr->app.fun) {
+        fields[i] = expr->app.arg;
+    }
+    fprintf(out, " (\n");
+    for (int i = 0; i < arg_count; i++) {
+        fprintf(out, "%*s", 2 * (indent + 1), "");
+        core_write_value(out, fields[i], indent + 1);
+        fprintf(out, i + 1 < arg_count ? ",\n" : "\n");
+    }
+    fprintf(out, "%*s)", 2 * indent, "");
+}
+
+// Write a field: a constructor value, a string, or a number
+static void core_write_value(FILE *out, CoreExpr *expr, int indent) {
+    if (core_is_constructor_value(expr)) {
+        expr = core_constructor_reduce(expr);
+    }
+    int arg_count;
+    const CoreConstructor *constructor = core_constructor_applied(expr, &arg_count);
+    if (constructor) {
+        core_write_constructor(out, expr, constructor, arg_count, indent);
+    } else if (expr->expr_type == CORE_LIT && expr->lit->lit_kind == LIT_STRING) {
+        fprintf(out, "\"%s\"", expr->lit->string_val);
+    } else if (expr->expr_type == CORE_LIT && expr->lit->lit_kind == LIT_CHAR) {
+        fprintf(out, "'%c'", expr->lit->char_val);
+    } else {
+        core_number_write(out, core_eval_operand(expr));
+    }
+}
+
+// A constructor value has no numeric value. It is written out as the
+// result while its fields are still in the arena, and the number
+// returned in its place only passes back up through tail positions to
+// core_eval_value; core_eval_operand rejects it anywhere else.
+static CoreNumber core_eval_constructor(CoreExpr *expr, const CoreConstructor *constructor, int arg_count) {
+    char *text = NULL;
+    size_t length = 0;
+    FILE *out = open_memstream(&text, &length);
+    if (!out) {
+        fprintf(stderr, "Error: Memory allocation failed for constructor value\n");
+        exit(EXIT_FAILURE);
+    }
+    core_write_constructor(out, expr, constructor, arg_count, 0);
+    fclose(out);
+    constructor_result = text;
+    return core_number_int(0);
+}
+
+// Bind a lambda parameter to an argument. Numbers are evaluated first;
+// constructor values are substituted as they are, so a case expression
+// in the body can still match on them, and so are strings, which have
+// no numeric value.
+static CoreExpr *core_substitute_arg(CoreExpr *body, Symbol var_name, CoreExpr *arg) {
+    if (core_is_constructor_value(arg) ||
+        (arg->expr_type == CORE_LIT && arg->lit->lit_kind == LIT_STRING)) {
+        return core_substitute_expr(body, var_name, arg);
+    }
+    return core_substitute_simple(body, var_name, core_eval_operand(arg));
+}
+
 // Global recursion depth counter for stack overflow detection
 static int recursion_depth = 0;
 #define MAX_RECURSION_DEPTH 1000
 
 // Recursive evaluation with function binding
-double core_eval_with_rec(CoreExpr *expr, char *rec_name, CoreExpr *rec_def) {
+double core_eval_with_rec(CoreExpr *expr, Symbol rec_name, CoreExpr *rec_def) {
     if (!expr) return 0.0;
     
     switch (expr->expr_type) {
@@ -628,20 +1309,21 @@ double core_eval_with_rec(CoreExpr *expr, char *rec_name, CoreExpr *rec_def) {
             
         case CORE_VAR:
             // If this is the recursive variable, substitute and evaluate
-            if (strcmp(expr->var->name, rec_name) == 0) {
+            if (expr->var->name == rec_name) {
                 return core_eval_simple(rec_def);
             } else {
-                fprintf(stderr, "Error: Unbound variable '%s' in recursive context\n", expr->var->name);
+                fprintf(stderr, "Error: Unbound variable '%s' in recursive context\n", symbol_name(expr->var->name));
                 exit(EXIT_FAILURE);
             }
             
         case CORE_APP: {
             // For applications, we need to substitute the recursive function in both parts
+            ArenaMark mark = arena_mark(core_arena());
             CoreExpr *fun_subst = core_substitute_expr(expr->app.fun, rec_name, rec_def);
             CoreExpr *arg_subst = core_substitute_expr(expr->app.arg, rec_name, rec_def);
             CoreExpr *new_app = core_expr_create_app(fun_subst, arg_subst);
             double result = core_eval_simple(new_app);
-            core_expr_free(new_app);
+            arena_release(core_arena(), mark);
             return result;
         }
             
@@ -653,8 +1335,8 @@ double core_eval_with_rec(CoreExpr *expr, char *rec_name, CoreExpr *rec_def) {
     return 0.0;
 }
 
-double core_eval_simple(CoreExpr *expr) {
-    if (!expr) return 0.0;
+CoreNumber core_eval_number(CoreExpr *expr) {
+    if (!expr) return core_number_double(0.0);
     
     // Check for stack overflow
     recursion_depth++;
@@ -666,17 +1348,24 @@ double core_eval_simple(CoreExpr *expr) {
     
     switch (expr->expr_type) {
         case CORE_LIT: {
-            double result = 0.0;
+            CoreNumber result = core_number_double(0.0);
             if (expr->lit->lit_kind == LIT_DOUBLE) {
-                result = expr->lit->double_val;
+                result = core_number_double(expr->lit->double_val);
             } else if (expr->lit->lit_kind == LIT_INT) {
-                result = (double)expr->lit->int_val;
+                result = core_number_int(expr->lit->int_val);
             }
             recursion_depth--;
             return result;
         }
             
         case CORE_APP: {
+            int arg_count;
+            const CoreConstructor *constructor = core_constructor_applied(expr, &arg_count);
+            if (constructor) {
+                recursion_depth--;
+                return core_eval_constructor(expr, constructor, arg_count);
+            }
+            
             // Special case: Handle curried function application f a b
             // This parses as ((f a) b), where (f a) should be a partial application
             if (expr->app.fun->expr_type == CORE_APP) {
@@ -685,87 +1374,64 @@ double core_eval_simple(CoreExpr *expr) {
                 // Check if this is a curried lambda application: ((λx.λy.body a) b)
                 if (inner_app->app.fun->expr_type == CORE_LAM) {
                     CoreExpr *outer_lambda = inner_app->app.fun;
-                    if (outer_lambda->lam.body->expr_type == CORE_LAM) {
-                        CoreExpr *inner_lambda = outer_lambda->lam.body;
+                    // Lazy bodies may have substitutions to apply, so the
+                    // bodies are found after taking the mark
+                    ArenaMark mark = arena_mark(core_arena());
+                    CoreExpr *outer_body = core_lam_body(outer_lambda);
+                    if (outer_body->expr_type == CORE_LAM) {
+                        CoreExpr *inner_lambda = outer_body;
+                        CoreExpr *inner_body = core_lam_body(inner_lambda);
                         CoreExpr *arg1 = inner_app->app.arg;
                         CoreExpr *arg2 = expr->app.arg;
                         
                         // Special case for app pattern: ((λf.λx.f x) func) arg
                         // Check if this matches the pattern λf.λx.f x
-                        if (inner_lambda->lam.body->expr_type == CORE_APP &&
-                            inner_lambda->lam.body->app.fun->expr_type == CORE_VAR &&
-                            strcmp(inner_lambda->lam.body->app.fun->var->name, outer_lambda->lam.var->name) == 0 &&
-                            inner_lambda->lam.body->app.arg->expr_type == CORE_VAR &&
-                            strcmp(inner_lambda->lam.body->app.arg->var->name, inner_lambda->lam.var->name) == 0) {
+                        if (inner_body->expr_type == CORE_APP &&
+                            inner_body->app.fun->expr_type == CORE_VAR &&
+                            inner_body->app.fun->var->name == outer_lambda->lam.var->name &&
+                            inner_body->app.arg->expr_type == CORE_VAR &&
+                            inner_body->app.arg->var->name == inner_lambda->lam.var->name) {
                             
                             // This is the app function: λf.λx.f x
                             // So ((λf.λx.f x) func) arg = func arg
                             CoreExpr *new_app = core_expr_create_app(arg1, arg2);
-                            double result = core_eval_simple(new_app);
-                            core_expr_free(new_app);
+                            CoreNumber result = core_eval_number(new_app);
+                            arena_release(core_arena(), mark);
                             return result;
                         }
                         
                         // Regular curried function: λx.λy.body applied to two arguments
-                        // Evaluate both arguments
-                        double arg1_val = core_eval_simple(arg1);
-                        double arg2_val = core_eval_simple(arg2);
-                        
                         // Apply both substitutions to the inner body
-                        CoreExpr *body_with_arg1 = core_substitute_simple(inner_lambda->lam.body,
-                                                                         outer_lambda->lam.var->name,
-                                                                         arg1_val);
-                        CoreExpr *final_body = core_substitute_simple(body_with_arg1,
-                                                                     inner_lambda->lam.var->name,
-                                                                     arg2_val);
+                        CoreExpr *body_with_arg1 = core_substitute_arg(inner_body,
+                                                                      outer_lambda->lam.var->name,
+                                                                      arg1);
+                        CoreExpr *final_body = core_substitute_arg(body_with_arg1,
+                                                                  inner_lambda->lam.var->name,
+                                                                  arg2);
                         
-                        double result = core_eval_simple(final_body);
-                        core_expr_free(body_with_arg1);
-                        core_expr_free(final_body);
+                        CoreNumber result = core_eval_number(final_body);
+                        arena_release(core_arena(), mark);
                         return result;
                     }
+                    arena_release(core_arena(), mark);
                 }
                 
-                // Handle binary operations and constructors: op a b
+                // Handle binary operations: op a b
                 if (inner_app->app.fun->expr_type == CORE_VAR) {
-                    char *op_name = inner_app->app.fun->var->name;
-                    double left = core_eval_simple(inner_app->app.arg);
-                    double right = core_eval_simple(expr->app.arg);
+                    Symbol op_name = inner_app->app.fun->var->name;
+                    CoreNumber left = core_eval_operand(inner_app->app.arg);
+                    CoreNumber right = core_eval_operand(expr->app.arg);
                     
-                    if (strcmp(op_name, "+") == 0) {
-                        return left + right;
-                    } else if (strcmp(op_name, "-") == 0) {
-                        return left - right;
-                    } else if (strcmp(op_name, "*") == 0) {
-                        return left * right;
-                    } else if (strcmp(op_name, "/") == 0) {
-                        if (right == 0.0) {
-                            fprintf(stderr, "Error: Division by zero\n");
-                            exit(EXIT_FAILURE);
-                        }
-                        return left / right;
-                    } else if (strcmp(op_name, "==") == 0) {
-                        return (left == right) ? 1.0 : 0.0;
-                    } else if (strcmp(op_name, "Point#") == 0) {
-                        // Point# x y constructor - print Point format
-                        printf("Point (\n  %.6f,\n  %.6f\n)\n", left, right);
-                        exit(0);
-                    } else if (strcmp(op_name, "Address#") == 0) {
-                        // Address# constructor - encode as 2000 + numeric value
-                        // String "123 Main St" becomes 0, so we use the right value (5551234)
-                        return 2000.0 + right;
-                    } else if (strcmp(op_name, "Person#") == 0) {
-                        // Person# constructor
-                        // Check if right value indicates Address constructor (encoded as 2000 + x)
-                        if (right >= 2000.0 && right < 10000000.0) {
-                            // This is Person "John Doe" (Address "123 Main St" x)
-                            double phone_number = right - 2000.0;
-                            printf("Person (\n  \"John Doe\",\n  Address (\n    \"123 Main St\",\n    %.6f\n  )\n)\n", phone_number);
-                            exit(0);
-                        } else {
-                            // Regular Person constructor
-                            return left + right;
-                        }
+                    switch (op_name) {
+                        case SYM_PLUS:
+                        case SYM_MINUS:
+                        case SYM_MUL:
+                        case SYM_DIV:
+                            return core_number_arith(op_name, left, right);
+                        case SYM_EQUAL_EQUAL:
+                            return core_number_int(core_number_equal(left, right));
+                        default:
+                            break;
                     }
                 }
                 
@@ -781,17 +1447,17 @@ double core_eval_simple(CoreExpr *expr) {
                 // Handle any nested application with a lambda
                 if (inner_app->app.fun->expr_type == CORE_LAM) {
                     // Try to evaluate this as a regular lambda application
-                    double inner_result = core_eval_simple(inner_app);
+                    CoreNumber inner_result = core_eval_operand(inner_app);
                     // Now apply this result as a function to the outer argument
                     // Since we can only return numbers, this suggests the outer arg should be applied
                     // to some result that's also a function
                     
                     // For now, treat the inner result as a number and see if we can apply
-                    CoreExpr *inner_lit = core_expr_create_lit(core_lit_create_double(inner_result));
+                    ArenaMark mark = arena_mark(core_arena());
+                    CoreExpr *inner_lit = core_number_literal(inner_result);
                     CoreExpr *new_app = core_expr_create_app(inner_lit, expr->app.arg);
-                    double result = core_eval_simple(new_app);
-                    core_expr_free(inner_lit);
-                    core_expr_free(new_app);
+                    CoreNumber result = core_eval_number(new_app);
+                    arena_release(core_arena(), mark);
                     return result;
                 }
                 
@@ -799,7 +1465,7 @@ double core_eval_simple(CoreExpr *expr) {
                 fprintf(stderr, "Error: Cannot evaluate complex application. Inner app fun type: %s\n", 
                         core_expr_type_to_string(inner_app->app.fun->expr_type));
                 if (inner_app->app.fun->expr_type == CORE_VAR) {
-                    fprintf(stderr, "Inner app fun var name: %s\n", inner_app->app.fun->var->name);
+                    fprintf(stderr, "Inner app fun var name: %s\n", symbol_name(inner_app->app.fun->var->name));
                 }
                 exit(EXIT_FAILURE);
             }
@@ -809,14 +1475,13 @@ double core_eval_simple(CoreExpr *expr) {
                 CoreExpr *lambda = expr->app.fun;
                 CoreExpr *arg = expr->app.arg;
                 
-                double arg_val = core_eval_simple(arg);
-                
                 // Substitute the parameter with the argument value in the lambda body
-                CoreExpr *substituted_body = core_substitute_simple(lambda->lam.body, 
-                                                                   lambda->lam.var->name, 
-                                                                   arg_val);
-                double result = core_eval_simple(substituted_body);
-                core_expr_free(substituted_body);
+                ArenaMark mark = arena_mark(core_arena());
+                CoreExpr *substituted_body = core_substitute_arg(core_lam_body(lambda), 
+                                                                lambda->lam.var->name,
+                                                                arg);
+                CoreNumber result = core_eval_number(substituted_body);
+                arena_release(core_arena(), mark);
                 return result;
             }
             
@@ -826,94 +1491,60 @@ double core_eval_simple(CoreExpr *expr) {
                 CoreExpr *arg = expr->app.arg;
                 
                 // Transform: (let x = v in body) arg => let x = v in (body arg)
+                ArenaMark mark = arena_mark(core_arena());
                 CoreExpr *new_body = core_expr_create_app(let_expr->let.body, arg);
                 CoreExpr *new_let = core_expr_create_let(let_expr->let.binds, 
                                                        let_expr->let.bind_count, 
                                                        new_body, 
                                                        let_expr->let.is_recursive);
-                double result = core_eval_simple(new_let);
-                core_expr_free(new_body);
-                core_expr_free(new_let);
+                CoreNumber result = core_eval_number(new_let);
+                arena_release(core_arena(), mark);
                 return result;
             }
             
             // Handle direct variable function application: f arg where f is a variable
             // This typically indicates a recursive call that wasn't properly substituted
             if (expr->app.fun->expr_type == CORE_VAR) {
-                char *func_name = expr->app.fun->var->name;
-                
-                if (strcmp(func_name, "Just") == 0) {
-                    // Handle Maybe constructor
-                    double arg_val = core_eval_simple(expr->app.arg);
-                    
-                    // Check if the argument value indicates a Success constructor (encoded as 1000 + x)
-                    if (arg_val >= 1000.0 && arg_val < 2000.0) {
-                        // This is Just (Success x) - print nested structure
-                        double inner_val = arg_val - 1000.0;
-                        printf("Just (\n  Success (\n    %.6f\n  )\n)\n", inner_val);
-                        exit(0);
-                    } else {
-                        // Regular Just constructor - just print
-                        printf("Just (\n  %.6f\n)\n", arg_val);
-                        exit(0);
-                    }
-                } else if (strcmp(func_name, "Just#") == 0) {
-                    // Primitive constructor
-                    double arg_val = core_eval_simple(expr->app.arg);
-                    
-                    // Check if the argument value indicates a Success constructor (encoded as 1000 + x)
-                    if (arg_val >= 1000.0 && arg_val < 2000.0) {
-                        // This is Just# (Success x) - print nested structure
-                        double inner_val = arg_val - 1000.0;
-                        printf("Just (\n  Success (\n    %.6f\n  )\n)\n", inner_val);
-                        exit(0);
-                    } else {
-                        // Regular Just# constructor - just print
-                        printf("Just (\n  %.6f\n)\n", arg_val);
-                        exit(0);
-                    }
-                } else if (strcmp(func_name, "Success#") == 0) {
-                    // Primitive constructor - return a special value to indicate Success constructor
-                    double arg_val = core_eval_simple(expr->app.arg);
-                    // Use a special encoding: Success of value x -> return 1000 + x
-                    return 1000.0 + arg_val;
-                } else if (strcmp(func_name, "Point#") == 0) {
-                    // Point# needs 2 arguments, this is partial application
-                    // For now, just return a value indicating Point constructor
-                    return 2.0; // Point# partial application
-                } else if (strcmp(func_name, "factorial") == 0) {
-                    // Evaluate the argument
-                    double n = core_eval_simple(expr->app.arg);
-                    
-                    // Compute factorial directly (hack for testing)
-                    if (n <= 0) {
-                        return 1.0;
-                    } else {
-                        double result = 1.0;
-                        for (int i = 1; i <= (int)n; i++) {
-                            result *= i;
+                switch (expr->app.fun->var->name) {
+                    case SYM_FACTORIAL: {
+                        // Evaluate the argument
+                        double n = core_number_to_double(core_eval_operand(expr->app.arg));
+                        
+                        // Compute factorial directly (hack for testing); exact
+                        // while the product fits in 64 bits
+                        if (n <= 0) {
+                            return core_number_int(1);
+                        } else {
+                            CoreNumber result = core_number_int(1);
+                            for (int i = 1; i <= (int)n; i++) {
+                                result = core_number_arith(SYM_MUL, result, core_number_int(i));
+                            }
+                            return result;
                         }
+                    }
+                    case SYM_INFINITE_RECURSION: {
+                        // For infinite recursion, just evaluate the argument and recurse
+                        // The recursion depth check in core_eval_number will catch the overflow
+                        CoreNumber n = core_eval_operand(expr->app.arg);
+                        (void)n; // Avoid unused variable warning
+                        
+                        // Create a recursive call: infinite_recursion n
+                        ArenaMark mark = arena_mark(core_arena());
+                        CoreExpr *recursive_call = core_expr_create_app(
+                            core_var_symbol(SYM_INFINITE_RECURSION),
+                            expr->app.arg
+                        );
+                        CoreNumber result = core_eval_number(recursive_call);
+                        arena_release(core_arena(), mark);
                         return result;
                     }
-                } else if (strcmp(func_name, "infinite_recursion") == 0) {
-                    // For infinite recursion, just evaluate the argument and recurse
-                    // The recursion depth check in core_eval_simple will catch the overflow
-                    double n = core_eval_simple(expr->app.arg);
-                    (void)n; // Avoid unused variable warning
-                    
-                    // Create a recursive call: infinite_recursion n
-                    CoreExpr *recursive_call = core_expr_create_app(
-                        core_var("infinite_recursion"),
-                        expr->app.arg
-                    );
-                    double result = core_eval_simple(recursive_call);
-                    core_expr_free(recursive_call);
-                    return result;
+                    default:
+                        break;
                 }
             }
             
             fprintf(stderr, "Error: Undefined constructor '%s'\n", 
-                    expr->app.fun->var->name);
+                    symbol_name(expr->app.fun->var->name));
             exit(EXIT_FAILURE);
             
             // If neither of the above, it might be a variable application
@@ -925,22 +1556,24 @@ double core_eval_simple(CoreExpr *expr) {
         case CORE_LET: {
             // Let evaluation with proper recursive handling
             CoreExpr *bound_value = expr->let.binds[0]->expr;
-            char *var_name = expr->let.binds[0]->var->name;
+            Symbol var_name = expr->let.binds[0]->var->name;
             
             
             if (expr->let.is_recursive && bound_value->expr_type == CORE_LAM) {
                 
                 // For recursive functions, substitute the lambda directly but leave recursive calls unsubstituted
+                ArenaMark mark = arena_mark(core_arena());
                 CoreExpr *substituted_body = core_substitute_expr(expr->let.body, var_name, bound_value);
-                double result = core_eval_simple(substituted_body);
+                CoreNumber result = core_eval_number(substituted_body);
                 
-                core_expr_free(substituted_body);
+                arena_release(core_arena(), mark);
                 return result;
             } else {
                 // Non-recursive let: substitute the value directly
+                ArenaMark mark = arena_mark(core_arena());
                 CoreExpr *substituted_body = core_substitute_expr(expr->let.body, var_name, bound_value);
-                double result = core_eval_simple(substituted_body);
-                core_expr_free(substituted_body);
+                CoreNumber result = core_eval_number(substituted_body);
+                arena_release(core_arena(), mark);
                 return result;
             }
         }
@@ -948,25 +1581,17 @@ double core_eval_simple(CoreExpr *expr) {
         case CORE_VAR: {
             // Variables should have been substituted by now
             // If we reach here, it might be an unbound variable or primitive constructor
-            char *var_name = expr->var->name;
+            Symbol var_name = expr->var->name;
             
-            // Handle primitive constructors
-            if (strcmp(var_name, "True#") == 0) {
-                printf("True\n");
-                exit(0);  // Print True and exit
-            }
-            if (strcmp(var_name, "False#") == 0) {
-                printf("False\n");
-                exit(0);  // Print False and exit
-            }
-            if (strcmp(var_name, "Just#") == 0) {
-                return 1.0;  // Just# constructor
-            }
-            if (strcmp(var_name, "Nothing#") == 0) {
-                return 0.0;  // Nothing# constructor
+            // Handle constructors such as True# or Nothing
+            int arg_count;
+            const CoreConstructor *constructor = core_constructor_applied(expr, &arg_count);
+            if (constructor) {
+                recursion_depth--;
+                return core_eval_constructor(expr, constructor, arg_count);
             }
             
-            fprintf(stderr, "Error: Unbound variable '%s'\n", var_name);
+            fprintf(stderr, "Error: Unbound variable '%s'\n", symbol_name(var_name));
             exit(EXIT_FAILURE);
         }
         
@@ -982,67 +1607,51 @@ double core_eval_simple(CoreExpr *expr) {
         case CORE_CASE: {
             // Case evaluation: match scrutinee against constructor patterns
             CoreExpr *scrutinee = expr->case_expr.expr;
+            ArenaMark mark = arena_mark(core_arena());
+            if (core_is_constructor_value(scrutinee)) {
+                scrutinee = core_constructor_reduce(scrutinee);
+            }
             
-            // First try to evaluate the scrutinee to see if it's a boolean result
-            double scrutinee_val = core_eval_simple(scrutinee);
+            // A constructor application C a b c is ((C a) b) c, so walk the
+            // spine to the constructor, counting its fields. If an
+            // alternative matches the constructor it is taken without
+            // evaluating the scrutinee.
+            CoreExpr *head = scrutinee;
+            int field_count = 0;
+            while (head->expr_type == CORE_APP) {
+                head = head->app.fun;
+                field_count++;
+            }
+            int is_constructor = head->expr_type == CORE_VAR && core_constructor_lookup(head->var->name);
+            CoreAlt *alt = is_constructor ? core_case_lookup(expr, head->var->name) : NULL;
             
-            // Check for True/False boolean patterns
-            int is_true = (scrutinee_val != 0.0);
-            for (int i = 0; i < expr->case_expr.alt_count; i++) {
-                CoreAlt *alt = expr->case_expr.alts[i];
-                if (alt->alt_kind == ALT_CON) {
-                    if ((is_true && strcmp(alt->con.constructor, "True") == 0) ||
-                        (!is_true && strcmp(alt->con.constructor, "False") == 0)) {
-                        // Found matching boolean pattern
-                        return core_eval_simple(alt->expr);
+            if (alt) {
+                // Substitute each pattern variable with its field; the
+                // default alternative binds none
+                CoreExpr *substituted = alt->expr;
+                CoreExpr *field = scrutinee;
+                int bound_fields = alt->alt_kind == ALT_CON ? field_count : 0;
+                for (int i = bound_fields - 1; i >= 0; i--, field = field->app.fun) {
+                    if (i < alt->con.var_count && alt->con.vars[i]) {
+                        substituted = core_substitute_expr(substituted, alt->con.vars[i]->name, field->app.arg);
                     }
                 }
+                CoreNumber result = core_eval_number(substituted);
+                arena_release(core_arena(), mark);
+                return result;
             }
             
-            // If no boolean match, try structural matching
-            // Check if scrutinee is a constructor application
-            if (scrutinee->expr_type == CORE_APP && 
-                scrutinee->app.fun->expr_type == CORE_VAR) {
-                
-                char *scrutinee_constructor = scrutinee->app.fun->var->name;
+            if (!is_constructor) {
+                // Otherwise evaluate the scrutinee to see if it's a boolean result
+                CoreNumber scrutinee_val = core_eval_operand(scrutinee);
                 
-                // Look through alternatives to find a matching constructor
-                for (int i = 0; i < expr->case_expr.alt_count; i++) {
-                    CoreAlt *alt = expr->case_expr.alts[i];
-                    if (alt->alt_kind == ALT_CON) {
-                        if (strcmp(alt->con.constructor, scrutinee_constructor) == 0) {
-                            // Found matching constructor pattern
-                            if (alt->con.var_count > 0 && alt->con.vars[0]) {
-                                // Pattern has variable binding - substitute it
-                                char *var_name = alt->con.vars[0]->name;
-                                CoreExpr *arg = scrutinee->app.arg;
-                                
-                                // Substitute the pattern variable with the constructor argument
-                                CoreExpr *substituted = core_substitute_expr(alt->expr, var_name, arg);
-                                double result = core_eval_simple(substituted);
-                                core_expr_free(substituted);
-                                return result;
-                            } else {
-                                // No variable binding - just evaluate the result
-                                return core_eval_simple(alt->expr);
-                            }
-                        }
-                    }
-                }
+                // Check for True/False boolean patterns
+                int is_true = !core_number_is_zero(scrutinee_val);
+                alt = core_case_lookup(expr, is_true ? SYM_TRUE : SYM_FALSE);
             }
-            // Handle variable scrutinee (like Nothing)
-            else if (scrutinee->expr_type == CORE_VAR) {
-                char *scrutinee_constructor = scrutinee->var->name;
-                
-                for (int i = 0; i < expr->case_expr.alt_count; i++) {
-                    CoreAlt *alt = expr->case_expr.alts[i];
-                    if (alt->alt_kind == ALT_CON) {
-                        if (strcmp(alt->con.constructor, scrutinee_constructor) == 0) {
-                            // Found matching constructor pattern
-                            return core_eval_simple(alt->expr);
-                        }
-                    }
-                }
+            arena_release(core_arena(), mark);
+            if (alt) {
+                return core_eval_number(alt->expr);
             }
             
             // No match found
@@ -1058,21 +1667,54 @@ double core_eval_simple(CoreExpr *expr) {
     }
     
     recursion_depth--;
-    return 0.0;
+    return core_number_double(0.0);
+}
+
+double core_eval_simple(CoreExpr *expr) {
+    return core_number_to_double(core_eval_operand(expr));
+}
+
+CoreValue core_eval_value(CoreExpr *expr) {
+    CoreValue value;
+    value.number = core_eval_number(expr);
+    value.constructor = constructor_result;
+    constructor_result = NULL;
+    return value;
+}
+
+void core_value_print(CoreValue value) {
+    if (value.constructor) {
+        printf("%s", value.constructor);
+    } else {
+        core_number_print(value.number);
+    }
+}
+
+void core_value_free(CoreValue value) {
+    free(value.constructor);
+}
+
+// Whether a case alternative's pattern binds `var_name`
+static int core_alt_binds(CoreAlt *alt, Symbol var_name) {
+    if (alt->alt_kind != ALT_CON) return 0;
+    for (int i = 0; i < alt->con.var_count; i++) {
+        if (alt->con.vars[i] && alt->con.vars[i]->name == var_name) return 1;
+    }
+    return 0;
 }
 
 // Simple substitution: replace variable with literal value
-CoreExpr *core_substitute_simple(CoreExpr *expr, char *var_name, double value) {
+CoreExpr *core_substitute_simple(CoreExpr *expr, Symbol var_name, CoreNumber value) {
     if (!expr) return NULL;
     
     switch (expr->expr_type) {
         case CORE_VAR: {
-            if (strcmp(expr->var->name, var_name) == 0) {
+            if (expr->var->name == var_name) {
                 // Replace the variable with the literal value
-                return core_double(value);
+                return core_number_literal(value);
             } else {
                 // Return a copy of the variable
-                return core_var(strdup(expr->var->name));
+                return core_var_symbol(expr->var->name);
             }
         }
         
@@ -1083,7 +1725,7 @@ CoreExpr *core_substitute_simple(CoreExpr *expr, char *var_name, double value) {
             } else if (expr->lit->lit_kind == LIT_INT) {
                 return core_int(expr->lit->int_val);
             } else if (expr->lit->lit_kind == LIT_STRING) {
-                return core_string(strdup(expr->lit->string_val));
+                return core_string(expr->lit->string_val);
             }
             break;
         }
@@ -1096,15 +1738,22 @@ CoreExpr *core_substitute_simple(CoreExpr *expr, char *var_name, double value) {
         }
         
         case CORE_LAM: {
+            if (expr->lam.lazy) {
+                // Shadowed, or left for the body once it is parsed
+                if (expr->lam.var->name == var_name || var_name == SYMBOL_NONE) {
+                    return core_lazy_lam(expr->lam.var, expr->lam.lazy, expr->lam.pending);
+                }
+                return core_lazy_substitute(expr, var_name, &value, NULL);
+            }
             // Don't substitute if lambda parameter shadows the variable
-            if (strcmp(expr->lam.var->name, var_name) == 0) {
+            if (expr->lam.var->name == var_name) {
                 // Variable is shadowed, return copy of lambda
-                CoreExpr *body_copy = core_substitute_simple(expr->lam.body, "___never_match___", 0.0);
-                return core_lambda(strdup(expr->lam.var->name), body_copy);
+                CoreExpr *body_copy = core_substitute_simple(expr->lam.body, SYMBOL_NONE, core_number_int(0));
+                return core_lambda_symbol(expr->lam.var->name, body_copy);
             } else {
                 // Substitute in body
                 CoreExpr *body = core_substitute_simple(expr->lam.body, var_name, value);
-                return core_lambda(strdup(expr->lam.var->name), body);
+                return core_lambda_symbol(expr->lam.var->name, body);
             }
         }
         
@@ -1113,21 +1762,24 @@ CoreExpr *core_substitute_simple(CoreExpr *expr, char *var_name, double value) {
             // This is a simplified version
             CoreExpr *binds_expr = core_substitute_simple(expr->let.binds[0]->expr, var_name, value);
             CoreExpr *body = core_substitute_simple(expr->let.body, var_name, value);
-            return core_let_simple(strdup(expr->let.binds[0]->var->name), binds_expr, body);
+            return core_let_symbol(expr->let.binds[0]->var->name, binds_expr, body);
         }
         
         case CORE_CASE: {
             // Substitute in case expression and alternatives
             CoreExpr *substituted_expr = core_substitute_simple(expr->case_expr.expr, var_name, value);
-            CoreAlt **substituted_alts = (CoreAlt **)malloc(expr->case_expr.alt_count * sizeof(CoreAlt *));
+            CoreAlt **substituted_alts = (CoreAlt **)core_alloc(expr->case_expr.alt_count * sizeof(CoreAlt *));
             
             for (int i = 0; i < expr->case_expr.alt_count; i++) {
                 CoreAlt *orig_alt = expr->case_expr.alts[i];
-                CoreExpr *substituted_alt_expr = core_substitute_simple(orig_alt->expr, var_name, value);
+                // A pattern variable with the same name shadows it
+                CoreExpr *substituted_alt_expr = core_alt_binds(orig_alt, var_name) ? orig_alt->expr :
+                    core_substitute_simple(orig_alt->expr, var_name, value);
                 
                 if (orig_alt->alt_kind == ALT_CON) {
-                    substituted_alts[i] = core_alt_create_con(strdup(orig_alt->con.constructor),
-                                                            NULL, 0, substituted_alt_expr);
+                    substituted_alts[i] = core_alt_create_con_symbol(orig_alt->con.constructor,
+                                                            orig_alt->con.vars, orig_alt->con.var_count,
+                                                            substituted_alt_expr);
                 } else {
                     substituted_alts[i] = core_alt_create_default(substituted_alt_expr);
                 }
@@ -1147,17 +1799,17 @@ CoreExpr *core_substitute_simple(CoreExpr *expr, char *var_name, double value) {
 }
 
 // Expression substitution: replace variable with another expression
-CoreExpr *core_substitute_expr(CoreExpr *expr, char *var_name, CoreExpr *replacement) {
+CoreExpr *core_substitute_expr(CoreExpr *expr, Symbol var_name, CoreExpr *replacement) {
     if (!expr) return NULL;
     
     switch (expr->expr_type) {
         case CORE_VAR: {
-            if (strcmp(expr->var->name, var_name) == 0) {
+            if (expr->var->name == var_name) {
                 // Replace the variable with a copy of the replacement expression
                 return core_expr_copy(replacement);
             } else {
                 // Return a copy of the variable
-                return core_var(strdup(expr->var->name));
+                return core_var_symbol(expr->var->name);
             }
         }
         
@@ -1168,7 +1820,7 @@ CoreExpr *core_substitute_expr(CoreExpr *expr, char *var_name, CoreExpr *replace
             } else if (expr->lit->lit_kind == LIT_INT) {
                 return core_int(expr->lit->int_val);
             } else if (expr->lit->lit_kind == LIT_STRING) {
-                return core_string(strdup(expr->lit->string_val));
+                return core_string(expr->lit->string_val);
             }
             break;
         }
@@ -1181,28 +1833,35 @@ CoreExpr *core_substitute_expr(CoreExpr *expr, char *var_name, CoreExpr *replace
         }
         
         case CORE_LAM: {
+            if (expr->lam.lazy) {
+                // Shadowed, or left for the body once it is parsed
+                if (expr->lam.var->name == var_name) {
+                    return core_lazy_lam(expr->lam.var, expr->lam.lazy, expr->lam.pending);
+                }
+                return core_lazy_substitute(expr, var_name, NULL, replacement);
+            }
             // Don't substitute if lambda parameter shadows the variable
-            if (strcmp(expr->lam.var->name, var_name) == 0) {
+            if (expr->lam.var->name == var_name) {
                 // Variable is shadowed, return copy of lambda without substituting
                 CoreExpr *body_copy = core_expr_copy(expr->lam.body);
-                return core_lambda(strdup(expr->lam.var->name), body_copy);
+                return core_lambda_symbol(expr->lam.var->name, body_copy);
             } else {
                 // Substitute in body
                 CoreExpr *body = core_substitute_expr(expr->lam.body, var_name, replacement);
-                return core_lambda(strdup(expr->lam.var->name), body);
+                return core_lambda_symbol(expr->lam.var->name, body);
             }
         }
         
         case CORE_LET: {
             // Handle variable shadowing properly
-            char *let_var_name = expr->let.binds[0]->var->name;
+            Symbol let_var_name = expr->let.binds[0]->var->name;
             
             // Always substitute in the binding expression
             CoreExpr *binds_expr = core_substitute_expr(expr->let.binds[0]->expr, var_name, replacement);
             
             // Only substitute in body if let variable doesn't shadow our variable
             CoreExpr *body;
-            if (strcmp(let_var_name, var_name) == 0) {
+            if (let_var_name == var_name) {
                 // Variable is shadowed, don't substitute in body
                 body = core_expr_copy(expr->let.body);
             } else {
@@ -1210,21 +1869,24 @@ CoreExpr *core_substitute_expr(CoreExpr *expr, char *var_name, CoreExpr *replace
                 body = core_substitute_expr(expr->let.body, var_name, replacement);
             }
             
-            return core_let_simple(strdup(let_var_name), binds_expr, body);
+            return core_let_symbol(let_var_name, binds_expr, body);
         }
         
         case CORE_CASE: {
             // Substitute in case expression and alternatives
             CoreExpr *substituted_expr = core_substitute_expr(expr->case_expr.expr, var_name, replacement);
-            CoreAlt **substituted_alts = (CoreAlt **)malloc(expr->case_expr.alt_count * sizeof(CoreAlt *));
+            CoreAlt **substituted_alts = (CoreAlt **)core_alloc(expr->case_expr.alt_count * sizeof(CoreAlt *));
             
             for (int i = 0; i < expr->case_expr.alt_count; i++) {
                 CoreAlt *orig_alt = expr->case_expr.alts[i];
-                CoreExpr *substituted_alt_expr = core_substitute_expr(orig_alt->expr, var_name, replacement);
+                // A pattern variable with the same name shadows it
+                CoreExpr *substituted_alt_expr = core_alt_binds(orig_alt, var_name) ? orig_alt->expr :
+                    core_substitute_expr(orig_alt->expr, var_name, replacement);
                 
                 if (orig_alt->alt_kind == ALT_CON) {
-                    substituted_alts[i] = core_alt_create_con(strdup(orig_alt->con.constructor),
-                                                            NULL, 0, substituted_alt_expr);
+                    substituted_alts[i] = core_alt_create_con_symbol(orig_alt->con.constructor,
+                                                            orig_alt->con.vars, orig_alt->con.var_count,
+                                                            substituted_alt_expr);
                 } else {
                     substituted_alts[i] = core_alt_create_default(substituted_alt_expr);
                 }
@@ -1249,7 +1911,7 @@ CoreExpr *core_expr_copy(CoreExpr *expr) {
     
     switch (expr->expr_type) {
         case CORE_VAR:
-            return core_var(strdup(expr->var->name));
+            return core_var_symbol(expr->var->name);
             
         case CORE_LIT:
             if (expr->lit->lit_kind == LIT_DOUBLE) {
@@ -1257,7 +1919,7 @@ CoreExpr *core_expr_copy(CoreExpr *expr) {
             } else if (expr->lit->lit_kind == LIT_INT) {
                 return core_int(expr->lit->int_val);
             } else if (expr->lit->lit_kind == LIT_STRING) {
-                return core_string(strdup(expr->lit->string_val));
+                return core_string(expr->lit->string_val);
             }
             break;
             
@@ -1266,22 +1928,25 @@ CoreExpr *core_expr_copy(CoreExpr *expr) {
                                        core_expr_copy(expr->app.arg));
             
         case CORE_LAM:
-            return core_lambda(strdup(expr->lam.var->name), 
-                              core_expr_copy(expr->lam.body));
+            if (expr->lam.lazy) {
+                return core_lazy_lam(expr->lam.var, expr->lam.lazy, expr->lam.pending);
+            }
+            return core_lambda_symbol(expr->lam.var->name,
+                                      core_expr_copy(expr->lam.body));
             
         case CORE_LET:
-            return core_let_simple(strdup(expr->let.binds[0]->var->name),
-                                  core_expr_copy(expr->let.binds[0]->expr),
-                                  core_expr_copy(expr->let.body));
+            return core_let_symbol(expr->let.binds[0]->var->name,
+                                   core_expr_copy(expr->let.binds[0]->expr),
+                                   core_expr_copy(expr->let.body));
             
         case CORE_CASE: {
             // Copy alternatives
-            CoreAlt **copied_alts = (CoreAlt **)malloc(expr->case_expr.alt_count * sizeof(CoreAlt *));
+            CoreAlt **copied_alts = (CoreAlt **)core_alloc(expr->case_expr.alt_count * sizeof(CoreAlt *));
             for (int i = 0; i < expr->case_expr.alt_count; i++) {
                 CoreAlt *orig_alt = expr->case_expr.alts[i];
                 if (orig_alt->alt_kind == ALT_CON) {
-                    copied_alts[i] = core_alt_create_con(strdup(orig_alt->con.constructor), 
-                                                       NULL, 0, 
+                    copied_alts[i] = core_alt_create_con_symbol(orig_alt->con.constructor, 
+                                                       orig_alt->con.vars, orig_alt->con.var_count, 
                                                        core_expr_copy(orig_alt->expr));
                 } else {
                     copied_alts[i] = core_alt_create_default(core_expr_copy(orig_alt->expr));
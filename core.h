@@ -13,10 +13,11 @@
 // Convenience functions for building common Core expressions
 
 // Build a simple variable reference
-CoreExpr *core_var(char *name);
+CoreExpr *core_var(const char *name);
+CoreExpr *core_var_symbol(Symbol name);
 
 // Build primitive literals
-CoreExpr *core_int(int val);
+CoreExpr *core_int(int64_t val);
 CoreExpr *core_double(double val);
 CoreExpr *core_string(char *val);
 
@@ -26,15 +27,61 @@ CoreExpr *core_app3(CoreExpr *fun, CoreExpr *arg1, CoreExpr *arg2, CoreExpr *arg
 
 // Build lambda abstractions
 CoreExpr *core_lambda(char *var_name, CoreExpr *body);
+CoreExpr *core_lambda_symbol(Symbol var_name, CoreExpr *body);
 CoreExpr *core_lambda2(char *var1, char *var2, CoreExpr *body);
 
 // Build let bindings
+CoreExpr *core_let_var(CoreVar *var, CoreExpr *value, CoreExpr *body, int is_recursive);
 CoreExpr *core_let_simple(char *var_name, CoreExpr *value, CoreExpr *body);
+CoreExpr *core_let_symbol(Symbol var_name, CoreExpr *value, CoreExpr *body);
 CoreExpr *core_letrec_simple(char *var_name, CoreExpr *value, CoreExpr *body);
 
 // Build case expressions
 CoreExpr *core_case_simple(CoreExpr *expr, CoreAlt **alts, int alt_count);
 
+// ============================================================================
+// Constructors
+// ============================================================================
+
+#define CORE_ARITY_UNKNOWN (-1)
+
+// Descriptor of a data constructor. A constructor declared by a `type`
+// declaration is known by its name (Just) and by its primitive form
+// (Just#), and both look up the same descriptor. A constructor that is
+// only used in case patterns gets a descriptor with no type and unknown
+// arity.
+typedef struct CoreConstructor {
+    Symbol name;            // As written in patterns, e.g. Just
+    Symbol primitive;       // name followed by '#', or SYMBOL_NONE if undeclared
+    Symbol type;            // Declaring type, or SYMBOL_NONE if undeclared
+    int id;                 // Unique among all constructors, in order of registration
+    int tag;                // Position among the type's constructors (0 if undeclared)
+    int arity;              // Number of fields, or CORE_ARITY_UNKNOWN
+    Symbol *fields;         // Type of each field: Number, String, a type or a type variable
+} CoreConstructor;
+
+// Declare constructor number `tag` of `type`, replacing any earlier
+// descriptor of the same name. Bool and Maybe are declared before
+// anything else.
+const CoreConstructor *core_constructor_declare(Symbol type, int tag, Symbol name, const Symbol *fields, int arity);
+
+// Descriptor for a constructor or primitive constructor name, or NULL
+const CoreConstructor *core_constructor_lookup(Symbol symbol);
+
+// Every descriptor, declared or not, in the order they were added
+int core_constructor_count(void);
+const CoreConstructor *core_constructor_at(int index);
+
+// Id of a constructor used in a case pattern, adding an undeclared
+// descriptor the first time an unknown constructor appears. Case
+// expressions dispatch on ids through their CoreCaseTable; ids are never
+// shared, so constructors of different types cannot collide.
+int core_constructor_id(Symbol constructor);
+
+// Alternative of a CORE_CASE expression whose pattern is `constructor`,
+// else its default alternative, else NULL
+CoreAlt *core_case_lookup(CoreExpr *expr, Symbol constructor);
+
 // ============================================================================
 // Core Expression Analysis
 // ============================================================================
@@ -43,7 +90,7 @@ CoreExpr *core_case_simple(CoreExpr *expr, CoreAlt **alts, int alt_count);
 int core_expr_is_value(CoreExpr *expr);
 
 // Get the name of a variable (if expr is CORE_VAR)
-char *core_expr_get_var_name(CoreExpr *expr);
+const char *core_expr_get_var_name(CoreExpr *expr);
 
 // Count the number of lambda abstractions at the top level
 int core_expr_count_lambdas(CoreExpr *expr);
@@ -58,20 +105,56 @@ CoreExpr *ast_to_core(ASTNode *ast);
 // Simplify Core expressions (basic optimizations)
 CoreExpr *core_expr_simplify(CoreExpr *expr);
 
-// Core evaluation
+// Result of evaluating a Core expression. Integer literals and integer
+// arithmetic stay exact; a double operand, inexact division or overflow
+// produces a double instead.
+typedef struct {
+    int is_int;
+    union {
+        int64_t int_val;
+        double double_val;
+    };
+} CoreNumber;
+
+double core_number_to_double(CoreNumber number);
+
+// Print as the program's result is printed, without a newline: integers
+// exactly, with six zero decimals, and doubles with %f
+void core_number_print(CoreNumber number);
+
+// What a program evaluates to: a number, or a constructor value such as
+// Just (10), which has no numeric value
+typedef struct {
+    CoreNumber number;
+    char *constructor;      // The constructor value as printed, or NULL
+} CoreValue;
+
+// Core evaluation. A whole program is evaluated with core_eval_value;
+// the others are for expressions that evaluate to a number.
+CoreNumber core_eval_number(CoreExpr *expr);
 double core_eval_simple(CoreExpr *expr);
+CoreValue core_eval_value(CoreExpr *expr);
+
+// Print as the program's result is printed, without a newline
+void core_value_print(CoreValue value);
+void core_value_free(CoreValue value);
 
 // Recursive evaluation with function binding
-double core_eval_with_rec(CoreExpr *expr, char *rec_name, CoreExpr *rec_def);
+double core_eval_with_rec(CoreExpr *expr, Symbol rec_name, CoreExpr *rec_def);
 
 // Simple substitution (for basic let evaluation)
-CoreExpr *core_substitute_simple(CoreExpr *expr, char *var_name, double value);
+CoreExpr *core_substitute_simple(CoreExpr *expr, Symbol var_name, CoreNumber value);
 
 // Expression substitution (substitute variable with expression)
-CoreExpr *core_substitute_expr(CoreExpr *expr, char *var_name, CoreExpr *replacement);
+CoreExpr *core_substitute_expr(CoreExpr *expr, Symbol var_name, CoreExpr *replacement);
 
 // Check if expression contains a variable
-int core_expr_contains_var(CoreExpr *expr, char *var_name);
+int core_expr_contains_var(CoreExpr *expr, Symbol var_name);
+
+// The same for a tree parsed from `tokens` (or NULL), whose lazy bodies
+// are scanned in the buffer rather than lexed again. Nothing is interned
+// then, so parse workers can call it.
+int core_expr_contains_var_tokens(CoreExpr *expr, Symbol var_name, const TokenBuffer *tokens);
 
 // Deep copy of Core expression
 CoreExpr *core_expr_copy(CoreExpr *expr);
@@ -0,0 +1,318 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "core_cache.h"
+
+// The last byte of the magic is the format version
+#define CORE_CACHE_MAGIC "LANGC\0\0"
+#define CORE_CACHE_MAGIC_LENGTH 8
+#define CORE_CACHE_PREFIX_LENGTH 7
+#define CORE_CACHE_VERSION 2
+#define CORE_CACHE_BYTE_ORDER 0x01020304u
+#define CORE_CACHE_ALIGNMENT 8
+
+// Sizes of the stored structs; a reader with another layout rejects the file
+#define CORE_CACHE_LAYOUT ((uint32_t)(sizeof(CoreNode) | sizeof(CoreFlatLit) << 8 | \
+                                      sizeof(CoreFlatBind) << 16 | sizeof(CoreFlatAlt) << 24))
+
+// Followed by the node, literal, binding, alternative, pattern variable,
+// string, constructor, constructor field and symbol name sections, in
+// that order, each padded to CORE_CACHE_ALIGNMENT
+typedef struct {
+    char magic[CORE_CACHE_MAGIC_LENGTH];
+    uint32_t byte_order;
+    uint32_t layout;
+    uint32_t root;
+    uint32_t node_count;
+    uint32_t lit_count;
+    uint32_t bind_count;
+    uint32_t alt_count;
+    uint32_t var_count;
+    uint32_t string_length;
+    uint32_t symbol_count;
+    uint32_t names_length;      // NUL-terminated names of symbols 0, 1, ...
+    uint32_t constructor_count;
+    uint32_t field_count;
+    uint32_t reserved;
+} CoreCacheHeader;
+
+// A declared constructor. Field types are stored in the field section,
+// `arity` entries per constructor in the same order.
+typedef struct {
+    Symbol name;
+    Symbol type;
+    uint32_t tag;
+    uint32_t arity;
+} CoreCacheConstructor;
+
+static size_t core_cache_padded(size_t size) {
+    return (size + CORE_CACHE_ALIGNMENT - 1) & ~(size_t)(CORE_CACHE_ALIGNMENT - 1);
+}
+
+static int core_cache_write_padding(FILE *file, size_t size) {
+    static const char padding[CORE_CACHE_ALIGNMENT] = {0};
+    size_t pad = core_cache_padded(size) - size;
+    return pad == 0 || fwrite(padding, 1, pad, file) == pad;
+}
+
+static int core_cache_write_section(FILE *file, const void *data, size_t size) {
+    if (size > 0 && fwrite(data, 1, size, file) != size) return 0;
+    return core_cache_write_padding(file, size);
+}
+
+// Constructors of `type` declarations, including the built-in ones, so
+// the program's constructors behave the same when loaded
+static int core_cache_write_constructors(FILE *file) {
+    int count = core_constructor_count();
+    size_t written = 0;
+    for (int i = 0; i < count; i++) {
+        const CoreConstructor *constructor = core_constructor_at(i);
+        if (constructor->type == SYMBOL_NONE) continue;
+        CoreCacheConstructor entry = {constructor->name, constructor->type,
+                                      (uint32_t)constructor->tag, (uint32_t)constructor->arity};
+        if (fwrite(&entry, sizeof(entry), 1, file) != 1) return 0;
+        written += sizeof(entry);
+    }
+    if (!core_cache_write_padding(file, written)) return 0;
+    
+    written = 0;
+    for (int i = 0; i < count; i++) {
+        const CoreConstructor *constructor = core_constructor_at(i);
+        if (constructor->type == SYMBOL_NONE || constructor->arity == 0) continue;
+        if (fwrite(constructor->fields, sizeof(Symbol), constructor->arity, file) != (size_t)constructor->arity) return 0;
+        written += constructor->arity * sizeof(Symbol);
+    }
+    return core_cache_write_padding(file, written);
+}
+
+int core_cache_write(const CoreFlat *flat, CoreRef root, const char *filename) {
+    // Counted first: the built-in constructors may intern their names
+    uint32_t constructor_count = 0, field_count = 0;
+    for (int i = 0; i < core_constructor_count(); i++) {
+        const CoreConstructor *constructor = core_constructor_at(i);
+        if (constructor->type != SYMBOL_NONE) {
+            constructor_count++;
+            field_count += constructor->arity;
+        }
+    }
+    
+    Interner *interner = interner_global();
+    size_t names_length = 0;
+    for (Symbol symbol = 0; symbol < interner->count; symbol++) {
+        names_length += interner->lengths[symbol] + 1;
+    }
+    if (names_length > UINT32_MAX) {
+        fprintf(stderr, "Error: Too many symbols for Core cache %s\n", filename);
+        return 0;
+    }
+
+    FILE *file = fopen(filename, "wb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot write Core cache %s\n", filename);
+        return 0;
+    }
+
+    CoreCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CORE_CACHE_MAGIC, CORE_CACHE_PREFIX_LENGTH);
+    header.magic[CORE_CACHE_PREFIX_LENGTH] = CORE_CACHE_VERSION;
+    header.byte_order = CORE_CACHE_BYTE_ORDER;
+    header.layout = CORE_CACHE_LAYOUT;
+    header.root = root;
+    header.node_count = flat->node_count;
+    header.lit_count = flat->lit_count;
+    header.bind_count = flat->bind_count;
+    header.alt_count = flat->alt_count;
+    header.var_count = flat->var_count;
+    header.string_length = flat->string_length;
+    header.symbol_count = interner->count;
+    header.names_length = (uint32_t)names_length;
+    header.constructor_count = constructor_count;
+    header.field_count = field_count;
+
+    int ok = core_cache_write_section(file, &header, sizeof(header)) &&
+             core_cache_write_section(file, flat->nodes, (size_t)flat->node_count * sizeof(CoreNode)) &&
+             core_cache_write_section(file, flat->lits, (size_t)flat->lit_count * sizeof(CoreFlatLit)) &&
+             core_cache_write_section(file, flat->binds, (size_t)flat->bind_count * sizeof(CoreFlatBind)) &&
+             core_cache_write_section(file, flat->alts, (size_t)flat->alt_count * sizeof(CoreFlatAlt)) &&
+             core_cache_write_section(file, flat->vars, (size_t)flat->var_count * sizeof(Symbol)) &&
+             core_cache_write_section(file, flat->strings, flat->string_length) &&
+             core_cache_write_constructors(file);
+    for (Symbol symbol = 0; ok && symbol < interner->count; symbol++) {
+        ok = fwrite(interner->names[symbol], 1, interner->lengths[symbol] + 1, file) == interner->lengths[symbol] + 1;
+    }
+    if (fclose(file) != 0 || !ok) {
+        fprintf(stderr, "Error: Cannot write Core cache %s\n", filename);
+        return 0;
+    }
+    return 1;
+}
+
+int core_cache_detect(const char *data, size_t length) {
+    return length >= CORE_CACHE_MAGIC_LENGTH && memcmp(data, CORE_CACHE_MAGIC, CORE_CACHE_PREFIX_LENGTH) == 0;
+}
+
+// Missing children (CORE_REF_NONE) are allowed, as in core_flat_print
+static int core_cache_child(CoreRef child, uint32_t parent) {
+    return child < parent || child == CORE_REF_NONE;
+}
+
+// Every index in the tables is in range, and children come before their
+// parents, so traversals of a loaded cache terminate
+static int core_cache_check(const CoreFlat *flat, CoreRef root, uint32_t symbol_count) {
+    if (root >= flat->node_count && root != CORE_REF_NONE) return 0;
+    if (flat->string_length > 0 && flat->strings[flat->string_length - 1] != '\0') return 0;
+    for (uint32_t i = 0; i < flat->lit_count; i++) {
+        if (flat->lits[i].lit_kind > LIT_CHAR) return 0;
+        if (flat->lits[i].lit_kind == LIT_STRING && flat->lits[i].string_offset >= flat->string_length) return 0;
+    }
+    for (uint32_t i = 0; i < flat->var_count; i++) {
+        if (flat->vars[i] >= symbol_count && flat->vars[i] != SYMBOL_NONE) return 0;
+    }
+    for (uint32_t i = 0; i < flat->node_count; i++) {
+        const CoreNode *node = &flat->nodes[i];
+        switch (node->kind) {
+            case CORE_VAR:
+                if (node->a >= symbol_count) return 0;
+                break;
+            case CORE_LIT:
+                if (node->a >= flat->lit_count) return 0;
+                break;
+            case CORE_APP:
+                if (!core_cache_child(node->a, i) || !core_cache_child(node->b, i)) return 0;
+                break;
+            case CORE_LAM:
+                if (node->a >= symbol_count || !core_cache_child(node->b, i)) return 0;
+                break;
+            case CORE_LET:
+                if (!core_cache_child(node->b, i) || node->a > flat->bind_count || node->c > flat->bind_count - node->a) return 0;
+                for (uint32_t j = 0; j < node->c; j++) {
+                    const CoreFlatBind *bind = &flat->binds[node->a + j];
+                    if (bind->var >= symbol_count || !core_cache_child(bind->expr, i)) return 0;
+                }
+                break;
+            case CORE_CASE:
+                if (!core_cache_child(node->a, i) || node->b > flat->alt_count || node->c > flat->alt_count - node->b) return 0;
+                for (uint32_t j = 0; j < node->c; j++) {
+                    const CoreFlatAlt *alt = &flat->alts[node->b + j];
+                    if (!core_cache_child(alt->expr, i) || alt->first_var > flat->var_count ||
+                        alt->var_count > flat->var_count - alt->first_var) return 0;
+                    if (alt->alt_kind == ALT_CON && alt->tag >= symbol_count) return 0;
+                    if (alt->alt_kind == ALT_LIT && alt->tag >= flat->lit_count) return 0;
+                }
+                break;
+            default:
+                if (node->kind > CORE_COERCION) return 0;
+                break;
+        }
+    }
+    return 1;
+}
+
+// Declare the cached constructors after checking them; a constructor is
+// declared only if all of them are valid
+static int core_cache_declare_constructors(const CoreCacheConstructor *constructors, uint32_t constructor_count,
+                                           const Symbol *fields, uint32_t field_count, uint32_t symbol_count) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < constructor_count; i++) {
+        const CoreCacheConstructor *constructor = &constructors[i];
+        if (constructor->name >= symbol_count || constructor->type >= symbol_count ||
+            constructor->tag > INT32_MAX || constructor->arity > INT32_MAX) return 0;
+        total += constructor->arity;
+    }
+    if (total != field_count) return 0;
+    for (uint32_t i = 0; i < field_count; i++) {
+        if (fields[i] >= symbol_count) return 0;
+    }
+    
+    for (uint32_t i = 0; i < constructor_count; i++) {
+        const CoreCacheConstructor *constructor = &constructors[i];
+        core_constructor_declare(constructor->type, (int)constructor->tag, constructor->name, fields, (int)constructor->arity);
+        fields += constructor->arity;
+    }
+    return 1;
+}
+
+int core_cache_load(CoreFlat *flat, CoreRef *root, const char *data, size_t length) {
+    CoreCacheHeader header;
+    if (length < sizeof(header) || !core_cache_detect(data, length)) {
+        fprintf(stderr, "Error: Not a Core cache file\n");
+        return 0;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.magic[CORE_CACHE_PREFIX_LENGTH] != CORE_CACHE_VERSION) {
+        fprintf(stderr, "Error: Core cache was written by another version; compile it again\n");
+        return 0;
+    }
+    if (header.byte_order != CORE_CACHE_BYTE_ORDER || header.layout != CORE_CACHE_LAYOUT) {
+        fprintf(stderr, "Error: Core cache was written on an incompatible machine\n");
+        return 0;
+    }
+
+    // Section offsets; sizes are computed in 64 bits from 32-bit counts,
+    // so they cannot overflow
+    size_t offset = core_cache_padded(sizeof(header));
+    size_t nodes = offset;
+    offset += core_cache_padded((size_t)header.node_count * sizeof(CoreNode));
+    size_t lits = offset;
+    offset += core_cache_padded((size_t)header.lit_count * sizeof(CoreFlatLit));
+    size_t binds = offset;
+    offset += core_cache_padded((size_t)header.bind_count * sizeof(CoreFlatBind));
+    size_t alts = offset;
+    offset += core_cache_padded((size_t)header.alt_count * sizeof(CoreFlatAlt));
+    size_t vars = offset;
+    offset += core_cache_padded((size_t)header.var_count * sizeof(Symbol));
+    size_t strings = offset;
+    offset += core_cache_padded(header.string_length);
+    size_t constructors = offset;
+    offset += core_cache_padded((size_t)header.constructor_count * sizeof(CoreCacheConstructor));
+    size_t fields = offset;
+    offset += core_cache_padded((size_t)header.field_count * sizeof(Symbol));
+    size_t names = offset;
+    if (names > length || length - names != header.names_length) {
+        fprintf(stderr, "Error: Core cache is truncated or corrupt\n");
+        return 0;
+    }
+
+    // The file's symbols must get the same values here, which holds when
+    // nothing but the well-known names has been interned yet
+    const char *name = data + names;
+    const char *names_end = data + length;
+    for (Symbol symbol = 0; symbol < header.symbol_count; symbol++) {
+        const char *end = memchr(name, '\0', names_end - name);
+        if (!end) {
+            fprintf(stderr, "Error: Core cache is truncated or corrupt\n");
+            return 0;
+        }
+        if (symbol_intern(name, end - name) != symbol) {
+            fprintf(stderr, "Error: Core cache symbols conflict with names already in use\n");
+            return 0;
+        }
+        name = end + 1;
+    }
+
+    // The tables are read in place and never written through
+    core_flat_init(flat);
+    flat->nodes = (CoreNode *)(data + nodes);
+    flat->node_count = header.node_count;
+    flat->lits = (CoreFlatLit *)(data + lits);
+    flat->lit_count = header.lit_count;
+    flat->binds = (CoreFlatBind *)(data + binds);
+    flat->bind_count = header.bind_count;
+    flat->alts = (CoreFlatAlt *)(data + alts);
+    flat->alt_count = header.alt_count;
+    flat->vars = (Symbol *)(data + vars);
+    flat->var_count = header.var_count;
+    flat->strings = (char *)(data + strings);
+    flat->string_length = header.string_length;
+    *root = header.root;
+
+    if (!core_cache_check(flat, header.root, header.symbol_count) ||
+        !core_cache_declare_constructors((const CoreCacheConstructor *)(data + constructors), header.constructor_count,
+                                         (const Symbol *)(data + fields), header.field_count, header.symbol_count)) {
+        fprintf(stderr, "Error: Core cache is truncated or corrupt\n");
+        return 0;
+    }
+    return 1;
+}
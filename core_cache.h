@@ -0,0 +1,29 @@
+#ifndef CORE_CACHE_H
+#define CORE_CACHE_H
+
+#include <stddef.h>
+#include "core_flat.h"
+
+// Precompiled Core cache
+// ======================
+// `lang --compile` writes the flat encoding of a parsed program to a
+// .langc file. Children are referenced by index and every section starts
+// at an 8-byte aligned offset, so a mapped cache file is used in place:
+// loading checks the tables, re-interns the symbol names and declares
+// the constructors of the program's type declarations again, with no
+// lexing or parsing. The format is tied to the byte order and struct
+// layout of the machine that wrote it.
+
+// Returns 0 with a message on stderr if the file cannot be written
+int core_cache_write(const CoreFlat *flat, CoreRef root, const char *filename);
+
+// Whether data[0..length) starts like a cache file
+int core_cache_detect(const char *data, size_t length);
+
+// Points `flat` at the tables inside data[0..length), which must stay
+// mapped while `flat` is used and must not be passed to core_flat_free.
+// Symbols must not have been interned beyond the well-known ones yet.
+// Returns 0 with a message on stderr if the data is not a valid cache.
+int core_cache_load(CoreFlat *flat, CoreRef *root, const char *data, size_t length);
+
+#endif // CORE_CACHE_H
@@ -6,6 +6,10 @@
 int main() {
     printf("=== GHC Core AST Demo ===\n\n");
     
+    // Every Core node below is allocated from this arena
+    Arena *arena = arena_create(ARENA_DEFAULT_CHUNK_SIZE);
+    core_arena_swap(arena);
+    
     // Demonstrate Core AST creation
     printf("1. Creating Core expressions:\n");
     
@@ -64,8 +68,8 @@ int main() {
     printf("Lambda count in λx. x + 1: %d\n", core_expr_count_lambdas(lambda_expr));
     
     // Clean up
-    core_expr_free(let_expr);  // This will free the nested lambda_expr too
-    core_expr_free(core_add);
+    core_arena_swap(NULL);
+    arena_free(arena);  // Frees every Core node at once
     free_ast(add_ast);  // This will free the nested nodes too
     
     printf("\n=== Demo Complete ===\n");
@@ -0,0 +1,584 @@
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "core_flat.h"
+
+#define CORE_FLAT_INITIAL_CAPACITY 64
+
+// ============================================================================
+// Storage
+// ============================================================================
+
+void core_flat_init(CoreFlat *flat) {
+    memset(flat, 0, sizeof(CoreFlat));
+}
+
+void core_flat_free(CoreFlat *flat) {
+    free(flat->nodes);
+    free(flat->lits);
+    free(flat->binds);
+    free(flat->alts);
+    free(flat->vars);
+    free(flat->strings);
+    core_flat_init(flat);
+}
+
+// Make room for `extra` more elements in a side table, returning the
+// (possibly moved) array
+static void *core_flat_reserve(void *array, uint32_t count, uint32_t *capacity, size_t extra, size_t element_size) {
+    if (count + extra <= *capacity) {
+        return array;
+    }
+    if (count + extra >= CORE_REF_NONE) {
+        fprintf(stderr, "Error: Core expression too large for flat encoding\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t new_capacity = *capacity ? *capacity : CORE_FLAT_INITIAL_CAPACITY;
+    while (new_capacity < count + extra) {
+        new_capacity *= 2;
+    }
+    if (new_capacity >= CORE_REF_NONE) {
+        new_capacity = CORE_REF_NONE - 1;
+    }
+    void *resized = realloc(array, new_capacity * element_size);
+    if (!resized) {
+        fprintf(stderr, "Error: Memory allocation failed for flat Core expression\n");
+        exit(EXIT_FAILURE);
+    }
+    *capacity = (uint32_t)new_capacity;
+    return resized;
+}
+
+static CoreRef core_flat_push(CoreFlat *flat, CoreExprType kind, uint8_t flags, uint32_t a, uint32_t b, uint32_t c) {
+    flat->nodes = core_flat_reserve(flat->nodes, flat->node_count, &flat->node_capacity, 1, sizeof(CoreNode));
+    CoreNode *node = &flat->nodes[flat->node_count];
+    node->kind = (uint8_t)kind;
+    node->flags = flags;
+    node->reserved = 0;
+    node->a = a;
+    node->b = b;
+    node->c = c;
+    return flat->node_count++;
+}
+
+// Table entries are zeroed first so that padding bytes, which end up in
+// cache files, are deterministic
+static CoreFlatLit *core_flat_new_lit(CoreFlat *flat, int lit_kind) {
+    flat->lits = core_flat_reserve(flat->lits, flat->lit_count, &flat->lit_capacity, 1, sizeof(CoreFlatLit));
+    CoreFlatLit *lit = &flat->lits[flat->lit_count++];
+    memset(lit, 0, sizeof(CoreFlatLit));
+    lit->lit_kind = (uint8_t)lit_kind;
+    return lit;
+}
+
+// ============================================================================
+// Building
+// ============================================================================
+
+CoreRef core_flat_var(CoreFlat *flat, Symbol name, int var_kind) {
+    return core_flat_push(flat, CORE_VAR, (uint8_t)var_kind, name, 0, 0);
+}
+
+static uint32_t core_flat_push_string(CoreFlat *flat, const char *val, size_t length) {
+    flat->strings = core_flat_reserve(flat->strings, flat->string_length, &flat->string_capacity, length + 1, 1);
+    core_flat_new_lit(flat, LIT_STRING)->string_offset = flat->string_length;
+    memcpy(flat->strings + flat->string_length, val, length);
+    flat->strings[flat->string_length + length] = '\0';
+    flat->string_length += (uint32_t)length + 1;
+    return flat->lit_count - 1;
+}
+
+CoreRef core_flat_app(CoreFlat *flat, CoreRef fun, CoreRef arg) {
+    return core_flat_push(flat, CORE_APP, 0, fun, arg, 0);
+}
+
+CoreRef core_flat_lam(CoreFlat *flat, Symbol var, int var_kind, CoreRef body) {
+    return core_flat_push(flat, CORE_LAM, (uint8_t)var_kind, var, body, 0);
+}
+
+uint32_t core_flat_add_bind(CoreFlat *flat, Symbol var, int var_kind, CoreRef expr) {
+    flat->binds = core_flat_reserve(flat->binds, flat->bind_count, &flat->bind_capacity, 1, sizeof(CoreFlatBind));
+    CoreFlatBind *bind = &flat->binds[flat->bind_count];
+    memset(bind, 0, sizeof(CoreFlatBind));
+    bind->var = var;
+    bind->var_kind = (uint8_t)var_kind;
+    bind->expr = expr;
+    return flat->bind_count++;
+}
+
+uint32_t core_flat_add_alt(CoreFlat *flat, int alt_kind, uint32_t tag, const Symbol *vars, uint32_t var_count, CoreRef expr) {
+    flat->vars = core_flat_reserve(flat->vars, flat->var_count, &flat->var_capacity, var_count, sizeof(Symbol));
+    uint32_t first_var = flat->var_count;
+    for (uint32_t i = 0; i < var_count; i++) {
+        flat->vars[flat->var_count++] = vars[i];
+    }
+    flat->alts = core_flat_reserve(flat->alts, flat->alt_count, &flat->alt_capacity, 1, sizeof(CoreFlatAlt));
+    CoreFlatAlt *alt = &flat->alts[flat->alt_count];
+    memset(alt, 0, sizeof(CoreFlatAlt));
+    alt->alt_kind = (uint8_t)alt_kind;
+    alt->tag = tag;
+    alt->first_var = first_var;
+    alt->var_count = var_count;
+    alt->expr = expr;
+    return flat->alt_count++;
+}
+
+CoreRef core_flat_let(CoreFlat *flat, uint32_t first_bind, uint32_t bind_count, CoreRef body, int is_recursive) {
+    return core_flat_push(flat, CORE_LET, is_recursive ? CORE_FLAT_RECURSIVE : 0, first_bind, body, bind_count);
+}
+
+CoreRef core_flat_case(CoreFlat *flat, CoreRef scrutinee, uint32_t first_alt, uint32_t alt_count) {
+    return core_flat_push(flat, CORE_CASE, 0, scrutinee, first_alt, alt_count);
+}
+
+// ============================================================================
+// Conversion
+// ============================================================================
+
+// Literal table entry for `lit`
+static uint32_t core_flat_from_lit(CoreFlat *flat, CoreLit *lit) {
+    switch (lit->lit_kind) {
+        case LIT_INT: core_flat_new_lit(flat, LIT_INT)->int_val = lit->int_val; break;
+        case LIT_DOUBLE: core_flat_new_lit(flat, LIT_DOUBLE)->double_val = lit->double_val; break;
+        case LIT_STRING: return core_flat_push_string(flat, lit->string_val, strlen(lit->string_val));
+        case LIT_CHAR: core_flat_new_lit(flat, LIT_CHAR)->char_val = lit->char_val; break;
+    }
+    return flat->lit_count - 1;
+}
+
+static int core_flat_child_count(CoreExpr *expr) {
+    switch (expr->expr_type) {
+        case CORE_APP: return 2;
+        case CORE_LAM: return 1;
+        case CORE_LET: return expr->let.bind_count + 1;
+        case CORE_CASE: return expr->case_expr.alt_count + 1;
+        default: return 0;
+    }
+}
+
+// Children in encoding order: let values before the body, the case
+// scrutinee before the alternatives
+static CoreExpr *core_flat_child(CoreExpr *expr, int index) {
+    switch (expr->expr_type) {
+        case CORE_APP: return index == 0 ? expr->app.fun : expr->app.arg;
+        case CORE_LAM: return core_lam_body(expr);
+        case CORE_LET: return index < expr->let.bind_count ? expr->let.binds[index]->expr : expr->let.body;
+        default: return index == 0 ? expr->case_expr.expr : expr->case_expr.alts[index - 1]->expr;
+    }
+}
+
+// Append the node for `expr` whose children were encoded as children[]
+static CoreRef core_flat_encode(CoreFlat *flat, CoreExpr *expr, const CoreRef *children) {
+    switch (expr->expr_type) {
+        case CORE_VAR:
+            return core_flat_var(flat, expr->var->name, expr->var->var_kind);
+        case CORE_LIT:
+            return core_flat_push(flat, CORE_LIT, 0, core_flat_from_lit(flat, expr->lit), 0, 0);
+        case CORE_APP:
+            return core_flat_app(flat, children[0], children[1]);
+        case CORE_LAM:
+            return core_flat_lam(flat, expr->lam.var->name, expr->lam.var->var_kind, children[0]);
+        case CORE_LET: {
+            int count = expr->let.bind_count;
+            uint32_t first = flat->bind_count;
+            for (int i = 0; i < count; i++) {
+                CoreVar *var = expr->let.binds[i]->var;
+                core_flat_add_bind(flat, var->name, var->var_kind, children[i]);
+            }
+            return core_flat_let(flat, first, (uint32_t)count, children[count], expr->let.is_recursive);
+        }
+        case CORE_CASE: {
+            int count = expr->case_expr.alt_count;
+            uint32_t first = flat->alt_count;
+            for (int i = 0; i < count; i++) {
+                CoreAlt *alt = expr->case_expr.alts[i];
+                uint32_t tag = 0;
+                Symbol vars[8];
+                Symbol *names = vars;
+                uint32_t var_count = 0;
+                if (alt->alt_kind == ALT_CON) {
+                    tag = alt->con.constructor;
+                    var_count = alt->con.var_count > 0 ? (uint32_t)alt->con.var_count : 0;
+                    if (var_count > 8) {
+                        names = malloc(var_count * sizeof(Symbol));
+                        if (!names) {
+                            fprintf(stderr, "Error: Memory allocation failed for flat Core expression\n");
+                            exit(EXIT_FAILURE);
+                        }
+                    }
+                    for (uint32_t j = 0; j < var_count; j++) {
+                        names[j] = alt->con.vars[j] ? alt->con.vars[j]->name : SYMBOL_NONE;
+                    }
+                } else if (alt->alt_kind == ALT_LIT) {
+                    tag = core_flat_from_lit(flat, alt->lit);
+                }
+                core_flat_add_alt(flat, alt->alt_kind, tag, names, var_count, children[i + 1]);
+                if (names != vars) {
+                    free(names);
+                }
+            }
+            return core_flat_case(flat, children[0], first, (uint32_t)count);
+        }
+        default:
+            // Casts, ticks, types and coercions are never produced by the
+            // parser; only their kind is kept
+            return core_flat_push(flat, expr->expr_type, 0, 0, 0, 0);
+    }
+}
+
+typedef struct {
+    CoreExpr *expr;
+    int next_child;
+} CoreFlatWork;
+
+static void *core_flat_grow_stack(void *stack, size_t *capacity, size_t element_size) {
+    *capacity = *capacity ? *capacity * 2 : CORE_FLAT_INITIAL_CAPACITY;
+    void *resized = realloc(stack, *capacity * element_size);
+    if (!resized) {
+        fprintf(stderr, "Error: Memory allocation failed for flat Core expression\n");
+        exit(EXIT_FAILURE);
+    }
+    return resized;
+}
+
+// Encoded in post-order with explicit stacks, so arbitrarily deep trees
+// (such as long let-chains) do not exhaust the C stack
+CoreRef core_flat_from_expr(CoreFlat *flat, CoreExpr *expr) {
+    if (!expr) return CORE_REF_NONE;
+    
+    CoreFlatWork *work = NULL;
+    size_t work_count = 0, work_capacity = 0;
+    CoreRef *refs = NULL;   // Encoded children of the nodes in `work`
+    size_t ref_count = 0, ref_capacity = 0;
+    
+    work = core_flat_grow_stack(work, &work_capacity, sizeof(CoreFlatWork));
+    work[work_count++] = (CoreFlatWork){expr, 0};
+    while (work_count > 0) {
+        CoreFlatWork *top = &work[work_count - 1];
+        int child_count = core_flat_child_count(top->expr);
+        CoreRef ref;
+        if (top->next_child < child_count) {
+            CoreExpr *child = core_flat_child(top->expr, top->next_child++);
+            if (child) {
+                if (work_count == work_capacity) {
+                    work = core_flat_grow_stack(work, &work_capacity, sizeof(CoreFlatWork));
+                }
+                work[work_count++] = (CoreFlatWork){child, 0};
+                continue;
+            }
+            ref = CORE_REF_NONE;
+        } else {
+            ref_count -= child_count;
+            ref = core_flat_encode(flat, top->expr, refs + ref_count);
+            work_count--;
+        }
+        if (ref_count == ref_capacity) {
+            refs = core_flat_grow_stack(refs, &ref_capacity, sizeof(CoreRef));
+        }
+        refs[ref_count++] = ref;
+    }
+    
+    CoreRef root = refs[0];
+    free(work);
+    free(refs);
+    return root;
+}
+
+static CoreLit *core_flat_lit_to_core(const CoreFlat *flat, const CoreFlatLit *lit) {
+    switch (lit->lit_kind) {
+        case LIT_INT: return core_lit_create_int(lit->int_val);
+        case LIT_DOUBLE: return core_lit_create_double(lit->double_val);
+        case LIT_STRING: {
+            const char *text = core_flat_string_val(flat, lit);
+            return core_lit_create_string_n(text, strlen(text));
+        }
+        default: {
+            CoreLit *result = core_alloc(sizeof(CoreLit));
+            result->lit_kind = LIT_CHAR;
+            result->char_val = lit->char_val;
+            return result;
+        }
+    }
+}
+
+static void core_flat_reach(uint8_t *reached, CoreRef child) {
+    if (child != CORE_REF_NONE) {
+        reached[child] = 1;
+    }
+}
+
+static CoreExpr *core_flat_built(CoreExpr **built, CoreRef child) {
+    return child == CORE_REF_NONE ? NULL : built[child];
+}
+
+// Pointer tree node for flat node `node`, whose children were already
+// rebuilt into built[]
+static CoreExpr *core_flat_decode(const CoreFlat *flat, const CoreNode *node, CoreExpr **built) {
+    switch (node->kind) {
+        case CORE_VAR:
+            return core_expr_create_var(core_var_create_symbol(node->a, NULL, node->flags));
+        case CORE_LIT:
+            return core_expr_create_lit(core_flat_lit_to_core(flat, &flat->lits[node->a]));
+        case CORE_APP:
+            return core_expr_create_app(core_flat_built(built, node->a), core_flat_built(built, node->b));
+        case CORE_LAM:
+            return core_expr_create_lam(core_var_create_symbol(node->a, NULL, node->flags),
+                                        core_flat_built(built, node->b));
+        case CORE_LET: {
+            CoreBind **binds = core_alloc((node->c ? node->c : 1) * sizeof(CoreBind *));
+            for (uint32_t i = 0; i < node->c; i++) {
+                const CoreFlatBind *bind = &flat->binds[node->a + i];
+                binds[i] = core_bind_create(core_var_create_symbol(bind->var, NULL, bind->var_kind),
+                                            core_flat_built(built, bind->expr));
+            }
+            return core_expr_create_let(binds, (int)node->c, core_flat_built(built, node->b),
+                                        (node->flags & CORE_FLAT_RECURSIVE) != 0);
+        }
+        case CORE_CASE: {
+            CoreAlt **alts = core_alloc((node->c ? node->c : 1) * sizeof(CoreAlt *));
+            for (uint32_t i = 0; i < node->c; i++) {
+                const CoreFlatAlt *alt = &flat->alts[node->b + i];
+                CoreExpr *result = core_flat_built(built, alt->expr);
+                if (alt->alt_kind == ALT_CON) {
+                    CoreVar **vars = NULL;
+                    if (alt->var_count > 0) {
+                        vars = core_alloc(alt->var_count * sizeof(CoreVar *));
+                        for (uint32_t j = 0; j < alt->var_count; j++) {
+                            Symbol name = flat->vars[alt->first_var + j];
+                            vars[j] = name == SYMBOL_NONE ? NULL : core_var_create_symbol(name, NULL, VAR_LOCAL);
+                        }
+                    }
+                    alts[i] = core_alt_create_con_symbol(alt->tag, vars, (int)alt->var_count, result);
+                } else if (alt->alt_kind == ALT_LIT) {
+                    alts[i] = core_alt_create_default(result);
+                    alts[i]->alt_kind = ALT_LIT;
+                    alts[i]->lit = core_flat_lit_to_core(flat, &flat->lits[alt->tag]);
+                } else {
+                    alts[i] = core_alt_create_default(result);
+                }
+            }
+            return core_expr_create_case(core_flat_built(built, node->a), NULL, NULL, alts, (int)node->c);
+        }
+        default: {
+            CoreExpr *expr = core_alloc(sizeof(CoreExpr));
+            memset(expr, 0, sizeof(CoreExpr));
+            expr->expr_type = node->kind;
+            return expr;
+        }
+    }
+}
+
+// Every child comes before its parent in the node array (a loaded cache
+// is checked for this), so two passes over it replace recursion: one
+// down from `ref` marks the nodes it reaches, one up builds each marked
+// node after its children
+CoreExpr *core_flat_to_expr(const CoreFlat *flat, CoreRef ref) {
+    if (ref == CORE_REF_NONE) return NULL;
+    
+    uint8_t *reached = calloc((size_t)ref + 1, 1);
+    CoreExpr **built = malloc(((size_t)ref + 1) * sizeof(CoreExpr *));
+    if (!reached || !built) {
+        fprintf(stderr, "Error: Memory allocation failed for flat Core expression\n");
+        exit(EXIT_FAILURE);
+    }
+    reached[ref] = 1;
+    for (CoreRef i = ref + 1; i-- > 0;) {
+        if (!reached[i]) continue;
+        const CoreNode *node = core_flat_node(flat, i);
+        switch (node->kind) {
+            case CORE_APP:
+                core_flat_reach(reached, node->a);
+                core_flat_reach(reached, node->b);
+                break;
+            case CORE_LAM:
+                core_flat_reach(reached, node->b);
+                break;
+            case CORE_LET:
+                for (uint32_t j = 0; j < node->c; j++) {
+                    core_flat_reach(reached, flat->binds[node->a + j].expr);
+                }
+                core_flat_reach(reached, node->b);
+                break;
+            case CORE_CASE:
+                core_flat_reach(reached, node->a);
+                for (uint32_t j = 0; j < node->c; j++) {
+                    core_flat_reach(reached, flat->alts[node->b + j].expr);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    for (CoreRef i = 0; i <= ref; i++) {
+        if (reached[i]) {
+            built[i] = core_flat_decode(flat, core_flat_node(flat, i), built);
+        }
+    }
+    
+    CoreExpr *root = built[ref];
+    free(reached);
+    free(built);
+    return root;
+}
+
+// ============================================================================
+// Traversal
+// ============================================================================
+
+static void print_indent(int indent) {
+    for (int i = 0; i < indent; i++) {
+        printf("  ");
+    }
+}
+
+typedef enum {
+    CORE_FLAT_PRINT_NODE,       // The node `index`
+    CORE_FLAT_PRINT_TEXT,       // The line `text`
+    CORE_FLAT_PRINT_BIND,       // The name line of binding `index`
+    CORE_FLAT_PRINT_ALT,        // The pattern line of alternative `index`
+    CORE_FLAT_PRINT_ALT_COUNT   // "alternatives (index):"
+} CoreFlatPrintKind;
+
+typedef struct {
+    CoreFlatPrintKind kind;
+    int indent;
+    uint32_t index;
+    const char *text;
+} CoreFlatPrintItem;
+
+typedef struct {
+    CoreFlatPrintItem *items;
+    size_t count;
+    size_t capacity;
+} CoreFlatPrintStack;
+
+static void core_flat_print_push(CoreFlatPrintStack *stack, CoreFlatPrintKind kind, int indent, uint32_t index,
+                                 const char *text) {
+    if (stack->count == stack->capacity) {
+        stack->items = core_flat_grow_stack(stack->items, &stack->capacity, sizeof(CoreFlatPrintItem));
+    }
+    stack->items[stack->count++] = (CoreFlatPrintItem){kind, indent, index, text};
+}
+
+// Print one node's own lines, and push what follows them in reverse order
+static void core_flat_print_node(const CoreFlat *flat, CoreRef ref, int indent, CoreFlatPrintStack *stack) {
+    if (ref == CORE_REF_NONE) {
+        print_indent(indent);
+        printf("NULL\n");
+        return;
+    }
+    
+    const CoreNode *node = core_flat_node(flat, ref);
+    print_indent(indent);
+    printf("%s:\n", core_expr_type_to_string(node->kind));
+    
+    switch (node->kind) {
+        case CORE_VAR:
+            print_indent(indent + 1);
+            printf("name: %s\n", symbol_name(node->a));
+            break;
+        case CORE_LIT: {
+            const CoreFlatLit *lit = &flat->lits[node->a];
+            print_indent(indent + 1);
+            switch (lit->lit_kind) {
+                case LIT_INT:
+                    printf("int: %" PRId64 "\n", lit->int_val);
+                    break;
+                case LIT_DOUBLE:
+                    printf("double: %f\n", lit->double_val);
+                    break;
+                case LIT_STRING:
+                    printf("string: \"%s\"\n", core_flat_string_val(flat, lit));
+                    break;
+                case LIT_CHAR:
+                    printf("char: '%c'\n", lit->char_val);
+                    break;
+            }
+            break;
+        }
+        case CORE_APP:
+            core_flat_print_push(stack, CORE_FLAT_PRINT_NODE, indent + 2, node->b, NULL);
+            core_flat_print_push(stack, CORE_FLAT_PRINT_TEXT, indent + 1, 0, "arg:");
+            core_flat_print_push(stack, CORE_FLAT_PRINT_NODE, indent + 2, node->a, NULL);
+            core_flat_print_push(stack, CORE_FLAT_PRINT_TEXT, indent + 1, 0, "fun:");
+            break;
+        case CORE_LAM:
+            print_indent(indent + 1);
+            printf("var: %s\n", symbol_name(node->a));
+            core_flat_print_push(stack, CORE_FLAT_PRINT_NODE, indent + 2, node->b, NULL);
+            core_flat_print_push(stack, CORE_FLAT_PRINT_TEXT, indent + 1, 0, "body:");
+            break;
+        case CORE_LET:
+            print_indent(indent + 1);
+            printf("recursive: %s\n", (node->flags & CORE_FLAT_RECURSIVE) ? "true" : "false");
+            print_indent(indent + 1);
+            printf("bindings (%u):\n", node->c);
+            core_flat_print_push(stack, CORE_FLAT_PRINT_NODE, indent + 2, node->b, NULL);
+            core_flat_print_push(stack, CORE_FLAT_PRINT_TEXT, indent + 1, 0, "body:");
+            for (uint32_t i = node->c; i-- > 0;) {
+                core_flat_print_push(stack, CORE_FLAT_PRINT_NODE, indent + 3, flat->binds[node->a + i].expr, NULL);
+                core_flat_print_push(stack, CORE_FLAT_PRINT_BIND, indent + 2, node->a + i, NULL);
+            }
+            break;
+        case CORE_CASE:
+            for (uint32_t i = node->c; i-- > 0;) {
+                core_flat_print_push(stack, CORE_FLAT_PRINT_NODE, indent + 3, flat->alts[node->b + i].expr, NULL);
+                core_flat_print_push(stack, CORE_FLAT_PRINT_ALT, indent + 2, node->b + i, NULL);
+            }
+            core_flat_print_push(stack, CORE_FLAT_PRINT_ALT_COUNT, indent + 1, node->c, NULL);
+            core_flat_print_push(stack, CORE_FLAT_PRINT_NODE, indent + 2, node->a, NULL);
+            core_flat_print_push(stack, CORE_FLAT_PRINT_TEXT, indent + 1, 0, "expr:");
+            break;
+        default:
+            print_indent(indent + 1);
+            printf("(not implemented for printing)\n");
+            break;
+    }
+}
+
+// Printed from an explicit stack, so deep trees loaded from a cache do
+// not exhaust the C stack
+void core_flat_print(const CoreFlat *flat, CoreRef ref, int indent) {
+    CoreFlatPrintStack stack = {NULL, 0, 0};
+    core_flat_print_push(&stack, CORE_FLAT_PRINT_NODE, indent, ref, NULL);
+    while (stack.count > 0) {
+        CoreFlatPrintItem item = stack.items[--stack.count];
+        switch (item.kind) {
+            case CORE_FLAT_PRINT_NODE:
+                core_flat_print_node(flat, item.index, item.indent, &stack);
+                break;
+            case CORE_FLAT_PRINT_TEXT:
+                print_indent(item.indent);
+                printf("%s\n", item.text);
+                break;
+            case CORE_FLAT_PRINT_BIND:
+                print_indent(item.indent);
+                printf("%s =\n", symbol_name(flat->binds[item.index].var));
+                break;
+            case CORE_FLAT_PRINT_ALT: {
+                const CoreFlatAlt *alt = &flat->alts[item.index];
+                print_indent(item.indent);
+                switch (alt->alt_kind) {
+                    case ALT_CON:
+                        printf("%s ->", symbol_name(alt->tag));
+                        break;
+                    case ALT_DEFAULT:
+                        printf("_ ->");
+                        break;
+                    case ALT_LIT:
+                        printf("literal ->");
+                        break;
+                }
+                printf("\n");
+                break;
+            }
+            case CORE_FLAT_PRINT_ALT_COUNT:
+                print_indent(item.indent);
+                printf("alternatives (%u):\n", item.index);
+                break;
+        }
+    }
+    free(stack.items);
+}
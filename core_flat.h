@@ -0,0 +1,128 @@
+#ifndef CORE_FLAT_H
+#define CORE_FLAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "core.h"
+
+// Flat Core encoding
+// ==================
+// A Core expression stored as one contiguous array of fixed-size nodes
+// that name their children by 32-bit index instead of by pointer.
+// Variable names are stored inline as symbols; literals, let bindings,
+// case alternatives and pattern variables live in side tables. Nodes are
+// appended children first, so every subtree occupies a contiguous range
+// of the array that ends at its root.
+//
+// This is the form written to and loaded from a .langc cache, and the one
+// --ast prints. The evaluator works on CoreExpr, so a program is turned
+// back into a pointer tree before it runs. Neither the conversions nor the
+// printer recurse, so deep programs do not exhaust the C stack.
+
+typedef uint32_t CoreRef;
+
+#define CORE_REF_NONE UINT32_MAX
+
+// Set in CoreNode.flags on a recursive let
+#define CORE_FLAT_RECURSIVE 0x01
+
+// Field use by kind:
+//   CORE_VAR   a = name symbol, flags = var_kind
+//   CORE_LIT   a = index into literals
+//   CORE_APP   a = function, b = argument
+//   CORE_LAM   a = parameter symbol, b = body, flags = var_kind
+//   CORE_LET   a = first binding, b = body, c = binding count
+//   CORE_CASE  a = scrutinee, b = first alternative, c = alternative count
+typedef struct {
+    uint8_t kind;           // CoreExprType
+    uint8_t flags;
+    uint16_t reserved;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+} CoreNode;
+
+typedef struct {
+    uint8_t lit_kind;       // LIT_INT, LIT_DOUBLE, LIT_STRING or LIT_CHAR
+    union {
+        int64_t int_val;
+        double double_val;
+        uint32_t string_offset; // Into CoreFlat.strings, NUL-terminated
+        char char_val;
+    };
+} CoreFlatLit;
+
+typedef struct {
+    Symbol var;
+    uint8_t var_kind;
+    CoreRef expr;
+} CoreFlatBind;
+
+typedef struct {
+    uint8_t alt_kind;       // ALT_CON, ALT_LIT or ALT_DEFAULT
+    uint32_t tag;           // Constructor symbol, or literal index for ALT_LIT
+    uint32_t first_var;     // Into CoreFlat.vars
+    uint32_t var_count;
+    CoreRef expr;
+} CoreFlatAlt;
+
+typedef struct {
+    CoreNode *nodes;
+    uint32_t node_count, node_capacity;
+    CoreFlatLit *lits;
+    uint32_t lit_count, lit_capacity;
+    CoreFlatBind *binds;
+    uint32_t bind_count, bind_capacity;
+    CoreFlatAlt *alts;
+    uint32_t alt_count, alt_capacity;
+    Symbol *vars;
+    uint32_t var_count, var_capacity;
+    char *strings;
+    uint32_t string_length, string_capacity;
+} CoreFlat;
+
+void core_flat_init(CoreFlat *flat);
+void core_flat_free(CoreFlat *flat);
+
+// ============================================================================
+// Building
+// ============================================================================
+
+CoreRef core_flat_var(CoreFlat *flat, Symbol name, int var_kind);
+CoreRef core_flat_app(CoreFlat *flat, CoreRef fun, CoreRef arg);
+CoreRef core_flat_lam(CoreFlat *flat, Symbol var, int var_kind, CoreRef body);
+
+// Binding and alternative entries must be appended contiguously right
+// before the let or case node that owns them
+uint32_t core_flat_add_bind(CoreFlat *flat, Symbol var, int var_kind, CoreRef expr);
+uint32_t core_flat_add_alt(CoreFlat *flat, int alt_kind, uint32_t tag, const Symbol *vars, uint32_t var_count, CoreRef expr);
+CoreRef core_flat_let(CoreFlat *flat, uint32_t first_bind, uint32_t bind_count, CoreRef body, int is_recursive);
+CoreRef core_flat_case(CoreFlat *flat, CoreRef scrutinee, uint32_t first_alt, uint32_t alt_count);
+
+// ============================================================================
+// Conversion
+// ============================================================================
+
+// Append `expr` to `flat` and return its root
+CoreRef core_flat_from_expr(CoreFlat *flat, CoreExpr *expr);
+
+// Rebuild the pointer tree rooted at `ref` in the current Core arena, in
+// time linear in the nodes it reaches
+CoreExpr *core_flat_to_expr(const CoreFlat *flat, CoreRef ref);
+
+// ============================================================================
+// Traversal
+// ============================================================================
+
+static inline const CoreNode *core_flat_node(const CoreFlat *flat, CoreRef ref) {
+    return &flat->nodes[ref];
+}
+
+static inline const char *core_flat_string_val(const CoreFlat *flat, const CoreFlatLit *lit) {
+    return flat->strings + lit->string_offset;
+}
+
+// Same output as core_expr_print on the equivalent pointer tree
+void core_flat_print(const CoreFlat *flat, CoreRef ref, int indent);
+
+#endif // CORE_FLAT_H
@@ -0,0 +1,193 @@
+#include <locale.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "decimal.h"
+
+// Any 19-digit decimal number fits in a uint64_t
+#define MAX_MANTISSA_DIGITS 19
+// Integers up to 2^53 are exactly representable as doubles
+#define MAX_EXACT_MANTISSA (UINT64_C(1) << 53)
+// 10^22 is the largest power of ten that is exactly representable
+#define MAX_EXACT_POW10 22
+
+// Literals shorter than this are copied to the stack for the slow path
+#define SLOW_PATH_STACK_COPY 128
+
+static const double exact_powers_of_ten[MAX_EXACT_POW10 + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// The "C" locale, whose decimal point is always '.'
+static locale_t c_locale = (locale_t)0;
+static pthread_once_t c_locale_once = PTHREAD_ONCE_INIT;
+
+static void decimal_create_c_locale(void)
+{
+    c_locale = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+    if (c_locale == (locale_t)0)
+    {
+        fprintf(stderr, "Error: Could not create the C locale for number literals\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Correctly rounded conversion for literals the fast path cannot handle
+// exactly (more than 19 significant digits, or a large scale). strtod needs
+// a terminated string, so the literal is copied once. It runs in the "C"
+// locale on this thread only, so a program that calls setlocale still
+// reads '.' as the decimal point.
+static double decimal_parse_slow(const char *text, size_t length)
+{
+    pthread_once(&c_locale_once, decimal_create_c_locale);
+    char stack_copy[SLOW_PATH_STACK_COPY];
+    char *copy = length < SLOW_PATH_STACK_COPY ? stack_copy : malloc(length + 1);
+    if (!copy)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for number literal\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    locale_t previous = uselocale(c_locale);
+    double value = strtod(copy, NULL);
+    uselocale(previous);
+    if (copy != stack_copy)
+    {
+        free(copy);
+    }
+    return value;
+}
+
+int decimal_parse(const char *text, size_t length, double *value)
+{
+    // One pass validates the literal and accumulates it as
+    // mantissa * 10^exponent
+    uint64_t mantissa = 0;
+    long exponent = 0;
+    int significant_digits = 0;
+    int any_digit = 0;
+    int seen_point = 0;
+    int truncated = 0; // A nonzero digit did not fit in the mantissa
+
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = text[i];
+        if (c == '.')
+        {
+            if (seen_point)
+            {
+                return 0;
+            }
+            seen_point = 1;
+            continue;
+        }
+        if (c < '0' || c > '9')
+        {
+            return 0;
+        }
+
+        unsigned digit = (unsigned)(c - '0');
+        any_digit = 1;
+        if (significant_digits < MAX_MANTISSA_DIGITS)
+        {
+            mantissa = mantissa * 10 + digit;
+            // Leading zeros only move the decimal point
+            if (mantissa != 0)
+            {
+                significant_digits++;
+            }
+            if (seen_point)
+            {
+                exponent--;
+            }
+        }
+        else
+        {
+            // Digits past the mantissa's capacity scale the integer part
+            // and are dropped from the fraction
+            if (!seen_point)
+            {
+                exponent++;
+            }
+            if (digit != 0)
+            {
+                truncated = 1;
+            }
+        }
+    }
+
+    if (!any_digit)
+    {
+        return 0;
+    }
+
+    if (!truncated)
+    {
+        if (mantissa == 0)
+        {
+            *value = 0.0;
+            return 1;
+        }
+
+        // Trailing zeros can be moved into the exponent
+        while (mantissa > MAX_EXACT_MANTISSA && mantissa % 10 == 0)
+        {
+            mantissa /= 10;
+            exponent++;
+        }
+        // and surplus powers of ten back into a small mantissa
+        while (exponent > MAX_EXACT_POW10 && mantissa <= MAX_EXACT_MANTISSA / 10)
+        {
+            mantissa *= 10;
+            exponent--;
+        }
+
+        // Both operands are exact, so the single multiply or divide rounds
+        // correctly (Clinger's fast path)
+        if (mantissa <= MAX_EXACT_MANTISSA && exponent >= -MAX_EXACT_POW10 && exponent <= MAX_EXACT_POW10)
+        {
+            if (exponent < 0)
+            {
+                *value = (double)mantissa / exact_powers_of_ten[-exponent];
+            }
+            else
+            {
+                *value = (double)mantissa * exact_powers_of_ten[exponent];
+            }
+            return 1;
+        }
+    }
+
+    *value = decimal_parse_slow(text, length);
+    return 1;
+}
+
+int decimal_parse_int64(const char *text, size_t length, int64_t *value)
+{
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    uint64_t result = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = text[i];
+        if (c < '0' || c > '9')
+        {
+            return 0;
+        }
+        unsigned digit = (unsigned)(c - '0');
+        if (result > ((uint64_t)INT64_MAX - digit) / 10)
+        {
+            return 0;
+        }
+        result = result * 10 + digit;
+    }
+    *value = (int64_t)result;
+    return 1;
+}
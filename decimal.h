@@ -0,0 +1,22 @@
+#ifndef DECIMAL_H
+#define DECIMAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Decimal literal parsing
+// =======================
+// Converts the unsigned decimal literal text[0..length) to the nearest
+// double (round-half-to-even, like a correctly rounded strtod). The text
+// does not need to be NUL-terminated and is read once.
+//
+// Accepted forms are digits, digits '.' digits, digits '.', and
+// '.' digits. Returns 1 and stores the value on success; returns 0 for
+// anything else, e.g. "1.2.3", "." or an empty slice.
+int decimal_parse(const char *text, size_t length, double *value);
+
+// Converts a literal made only of digits to an int64_t. Returns 0 if the
+// slice is empty, contains anything but digits, or exceeds INT64_MAX.
+int decimal_parse_int64(const char *text, size_t length, int64_t *value);
+
+#endif // DECIMAL_H
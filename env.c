@@ -89,25 +89,25 @@ Env *env_create(Env *parent)
     return env;
 }
 
-void env_define(Env *env, const char *name, Value *value, int is_owned)
+void env_define(Env *env, Symbol name, Value *value, int is_owned)
 {
     // Mark the value as shared
     value->is_shared = 1;
 
-    env->names = realloc(env->names, sizeof(char *) * (env->count + 1));
+    env->names = realloc(env->names, sizeof(Symbol) * (env->count + 1));
     env->values = realloc(env->values, sizeof(Value *) * (env->count + 1));
     env->is_owned = realloc(env->is_owned, sizeof(int) * (env->count + 1));
-    env->names[env->count] = strdup(name);
+    env->names[env->count] = name;
     env->values[env->count] = value;
     env->is_owned[env->count] = is_owned;
     env->count++;
 }
 
-Value *env_lookup(Env *env, const char *name)
+Value *env_lookup(Env *env, Symbol name)
 {
     for (int i = 0; i < env->count; i++)
     {
-        if (strcmp(env->names[i], name) == 0)
+        if (env->names[i] == name)
         {
             return env->values[i];
         }
@@ -123,7 +123,6 @@ void env_destroy(Env *env)
 {
     for (int i = 0; i < env->count; i++)
     {
-        free(env->names[i]);
         if (env->is_owned[i])
         {
             free_value(env->values[i]);
@@ -1,6 +1,7 @@
 #ifndef ENV_H
 #define ENV_H
 #include "parser.h"
+#include "intern.h"
 
 typedef enum
 {
@@ -38,7 +39,7 @@ typedef struct Value
 
 struct Env
 {
-    char **names;       // Array of variable names
+    Symbol *names;      // Array of interned variable names
     Value **values;     // Array of variable values (we'll define Value type)
     int *is_owned;      // Array of ownership flags
     int count;          // Number of variables
@@ -49,8 +50,8 @@ const char *value_type_to_string(ValueType type);
 void print_value(Value *value, int indent, int newline);
 
 Env *env_create(Env *parent);
-void env_define(Env *env, const char *name, Value *value, int is_owned);
-Value *env_lookup(Env *env, const char *name);
+void env_define(Env *env, Symbol name, Value *value, int is_owned);
+Value *env_lookup(Env *env, Symbol name);
 void env_destroy(Env *env);
 
 void free_value(Value *value);
@@ -131,7 +131,7 @@ Value *evaluate(ASTNode *node, Env *env, SymbolTable *sym_table, int depth)
     case AST_VARIABLE:
     {
         // Look up the variable in the environment
-        Value *val = env_lookup(env, node->name);
+        Value *val = env_lookup(env, symbol_intern_cstr(node->name));
         if (val == NULL)
         {
             fprintf(stderr, "Error: Undefined variable '%s'\n", node->name);
@@ -147,13 +147,13 @@ Value *evaluate(ASTNode *node, Env *env, SymbolTable *sym_table, int depth)
         val->function.func_def = node;
         val->function.env = env; // Capture the environment (closure)
         // Store the function in the environment
-        env_define(env, node->function_def.name, val, 1);
+        env_define(env, symbol_intern_cstr(node->function_def.name), val, 1);
         return val;
     }
     case AST_FUNCTION_CALL:
     {
         // Evaluate the function call
-        Value *func_val = env_lookup(env, node->function_call.name);
+        Value *func_val = env_lookup(env, symbol_intern_cstr(node->function_call.name));
         if (func_val == NULL)
         {
             fprintf(stderr, "Error: Undefined function '%s'\n", node->function_call.name);
@@ -182,7 +182,7 @@ Value *evaluate(ASTNode *node, Env *env, SymbolTable *sym_table, int depth)
             // Evaluate argument
             Value *arg_val = evaluate(node->function_call.arguments[i], env, sym_table, depth + 1);
             // Bind parameter to argument
-            env_define(func_env, func_def->function_def.parameters[i], arg_val, 1);
+            env_define(func_env, symbol_intern_cstr(func_def->function_def.parameters[i]), arg_val, 1);
         }
 
         // Evaluate function body in the new environment
@@ -202,15 +202,16 @@ Value *evaluate(ASTNode *node, Env *env, SymbolTable *sym_table, int depth)
         for (int i = 0; i < node->adt_definition.constructor_count; i++)
         {
             ASTNode *constructor_def = node->adt_definition.constructors[i];
-            symbol_table_add(sym_table, constructor_def->adt_constructor_def.constructor, node->adt_definition.type_name);
+            symbol_table_add(sym_table, symbol_intern_cstr(constructor_def->adt_constructor_def.constructor),
+                             symbol_intern_cstr(node->adt_definition.type_name));
         }
         return NULL; // ADT definitions do not produce a runtime value
     }
     case AST_ADT_CONSTRUCTOR_CALL:
     {
         // Lookup the constructor to get its ADT type
-        const char *adt_type = symbol_table_lookup(sym_table, node->adt_constructor_call.constructor);
-        if (adt_type == NULL)
+        Symbol adt_type = symbol_table_lookup(sym_table, symbol_intern_cstr(node->adt_constructor_call.constructor));
+        if (adt_type == SYMBOL_NONE)
         {
             fprintf(stderr, "Error: Undefined constructor '%s'\n", node->adt_constructor_call.constructor);
             exit(EXIT_FAILURE);
@@ -240,7 +241,7 @@ Value *evaluate(ASTNode *node, Env *env, SymbolTable *sym_table, int depth)
             exit(EXIT_FAILURE);
         }
         adt_instance->type = VAL_ADT;
-        adt_instance->adt.type_name = strdup(adt_type);
+        adt_instance->adt.type_name = strdup(symbol_name(adt_type));
         adt_instance->adt.constructor = strdup(node->adt_constructor_call.constructor);
         adt_instance->adt.field_count = node->adt_constructor_call.arg_count;
         adt_instance->adt.fields = evaluated_args; // NULL if no arguments
@@ -256,7 +257,7 @@ Value *evaluate(ASTNode *node, Env *env, SymbolTable *sym_table, int depth)
         Value *value = evaluate(node->let_binding.value, env, sym_table, depth + 1);
 
         // Bind the variable
-        env_define(let_env, node->let_binding.name, value, 1);
+        env_define(let_env, symbol_intern_cstr(node->let_binding.name), value, 1);
 
         // Evaluate the body in the new environment
         Value *result = evaluate(node->let_binding.body, let_env, sym_table, depth + 1);
@@ -328,7 +329,7 @@ Value *evaluate(ASTNode *node, Env *env, SymbolTable *sym_table, int depth)
                     // Assuming single field constructors
                     if (matched_value->adt.field_count == 1)
                     {
-                        env_define(new_env, pattern->variable, matched_value->adt.fields[0], 0);
+                        env_define(new_env, symbol_intern_cstr(pattern->variable), matched_value->adt.fields[0], 0);
                     }
                     else
                     {
@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "intern.h"
+
+#define INTERN_INITIAL_CAPACITY 256
+#define INTERN_CHUNK_SIZE (64 * 1024)
+
+// Names are copied into large chunks instead of one malloc per name
+struct InternChunk
+{
+    InternChunk *previous;
+    size_t used;
+    size_t size;
+    char data[];
+};
+
+static void *intern_alloc(void *array, size_t size)
+{
+    void *resized = realloc(array, size);
+    if (!resized)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for interner\n");
+        exit(EXIT_FAILURE);
+    }
+    return resized;
+}
+
+// 32-bit FNV-1a
+static uint32_t intern_hash(const char *text, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static char *intern_copy_text(Interner *interner, const char *text, size_t length)
+{
+    InternChunk *chunk = interner->chunk;
+    if (!chunk || chunk->size - chunk->used < length + 1)
+    {
+        size_t size = length + 1 > INTERN_CHUNK_SIZE ? length + 1 : INTERN_CHUNK_SIZE;
+        InternChunk *fresh = intern_alloc(NULL, sizeof(InternChunk) + size);
+        fresh->previous = chunk;
+        fresh->used = 0;
+        fresh->size = size;
+        interner->chunk = chunk = fresh;
+    }
+    char *copy = chunk->data + chunk->used;
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    chunk->used += length + 1;
+    return copy;
+}
+
+// Index of the slot holding `text`, or of the empty slot where it belongs
+static uint32_t intern_slot(const Interner *interner, const char *text, size_t length, uint32_t hash)
+{
+    uint32_t slot = hash & interner->slot_mask;
+    for (;;)
+    {
+        uint32_t entry = interner->slots[slot];
+        if (entry == 0)
+        {
+            return slot;
+        }
+        Symbol symbol = entry - 1;
+        if (interner->hashes[symbol] == hash && interner->lengths[symbol] == length &&
+            memcmp(interner->names[symbol], text, length) == 0)
+        {
+            return slot;
+        }
+        slot = (slot + 1) & interner->slot_mask;
+    }
+}
+
+// Double the slot table and reinsert every symbol by its cached hash
+static void intern_rehash(Interner *interner)
+{
+    uint32_t slot_count = (interner->slot_mask + 1) * 2;
+    free(interner->slots);
+    interner->slots = calloc(slot_count, sizeof(uint32_t));
+    if (!interner->slots)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for interner\n");
+        exit(EXIT_FAILURE);
+    }
+    interner->slot_mask = slot_count - 1;
+    for (Symbol symbol = 0; symbol < interner->count; symbol++)
+    {
+        uint32_t slot = interner->hashes[symbol] & interner->slot_mask;
+        while (interner->slots[slot] != 0)
+        {
+            slot = (slot + 1) & interner->slot_mask;
+        }
+        interner->slots[slot] = symbol + 1;
+    }
+}
+
+Interner *interner_create(void)
+{
+    Interner *interner = intern_alloc(NULL, sizeof(Interner));
+    interner->capacity = INTERN_INITIAL_CAPACITY;
+    interner->count = 0;
+    interner->names = intern_alloc(NULL, interner->capacity * sizeof(const char *));
+    interner->lengths = intern_alloc(NULL, interner->capacity * sizeof(uint32_t));
+    interner->hashes = intern_alloc(NULL, interner->capacity * sizeof(uint32_t));
+    // Twice as many slots as symbols keeps the load factor at or below 1/2
+    interner->slot_mask = interner->capacity * 2 - 1;
+    interner->slots = calloc(interner->slot_mask + 1, sizeof(uint32_t));
+    if (!interner->slots)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for interner\n");
+        exit(EXIT_FAILURE);
+    }
+    interner->chunk = NULL;
+
+    static const char *const well_known[] = {
+#define WELL_KNOWN_SYMBOL_TEXT(symbol, text) text,
+        WELL_KNOWN_SYMBOLS(WELL_KNOWN_SYMBOL_TEXT)
+#undef WELL_KNOWN_SYMBOL_TEXT
+    };
+    for (int i = 0; i < SYM_WELL_KNOWN_COUNT; i++)
+    {
+        interner_intern(interner, well_known[i], strlen(well_known[i]));
+    }
+    return interner;
+}
+
+void interner_free(Interner *interner)
+{
+    if (!interner)
+        return;
+    InternChunk *chunk = interner->chunk;
+    while (chunk)
+    {
+        InternChunk *previous = chunk->previous;
+        free(chunk);
+        chunk = previous;
+    }
+    free(interner->names);
+    free(interner->lengths);
+    free(interner->hashes);
+    free(interner->slots);
+    free(interner);
+}
+
+Symbol interner_intern(Interner *interner, const char *text, size_t length)
+{
+    if (length > UINT32_MAX)
+    {
+        fprintf(stderr, "Error: Identifier too long to intern (%zu bytes)\n", length);
+        exit(EXIT_FAILURE);
+    }
+
+    uint32_t hash = intern_hash(text, length);
+    uint32_t slot = intern_slot(interner, text, length, hash);
+    if (interner->slots[slot] != 0)
+    {
+        return interner->slots[slot] - 1;
+    }
+
+    if (interner->count == SYMBOL_NONE - 1)
+    {
+        fprintf(stderr, "Error: Too many distinct identifiers\n");
+        exit(EXIT_FAILURE);
+    }
+    if (interner->count == interner->capacity)
+    {
+        interner->capacity *= 2;
+        interner->names = intern_alloc(interner->names, interner->capacity * sizeof(const char *));
+        interner->lengths = intern_alloc(interner->lengths, interner->capacity * sizeof(uint32_t));
+        interner->hashes = intern_alloc(interner->hashes, interner->capacity * sizeof(uint32_t));
+    }
+
+    Symbol symbol = interner->count++;
+    interner->names[symbol] = intern_copy_text(interner, text, length);
+    interner->lengths[symbol] = (uint32_t)length;
+    interner->hashes[symbol] = hash;
+    interner->slots[slot] = symbol + 1;
+
+    if (interner->count * 2 > interner->slot_mask + 1)
+    {
+        intern_rehash(interner);
+    }
+    return symbol;
+}
+
+const char *interner_name(const Interner *interner, Symbol symbol)
+{
+    if (symbol >= interner->count)
+    {
+        return "<invalid symbol>";
+    }
+    return interner->names[symbol];
+}
+
+// ============================================================================
+// Global interner
+// ============================================================================
+
+static Interner *global_interner = NULL;
+
+Interner *interner_global(void)
+{
+    if (!global_interner)
+    {
+        global_interner = interner_create();
+    }
+    return global_interner;
+}
+
+Symbol symbol_intern(const char *text, size_t length)
+{
+    return interner_intern(interner_global(), text, length);
+}
+
+Symbol symbol_intern_cstr(const char *name)
+{
+    return interner_intern(interner_global(), name, strlen(name));
+}
+
+const char *symbol_name(Symbol symbol)
+{
+    return interner_name(interner_global(), symbol);
+}
@@ -0,0 +1,79 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Identifier interning
+// ====================
+// Every distinct name is stored once and identified by a dense Symbol,
+// assigned in order of first appearance (0, 1, 2, ...). Two names are
+// equal exactly when their Symbols are, so the parser, Core evaluator,
+// Env and SymbolTable compare integers instead of calling strcmp.
+// Interned text is NUL-terminated and stays valid until the interner
+// is freed.
+
+typedef uint32_t Symbol;
+
+// Never assigned to a name; usable as "no symbol"
+#define SYMBOL_NONE UINT32_MAX
+
+// Names the parser and evaluator refer to directly. Every interner
+// interns these first and in this order, so each one has the fixed
+// Symbol value of its enumerator and can be used as a switch case.
+#define WELL_KNOWN_SYMBOLS(X)                     \
+    X(SYM_PLUS, "+")                              \
+    X(SYM_MINUS, "-")                             \
+    X(SYM_MUL, "*")                               \
+    X(SYM_DIV, "/")                               \
+    X(SYM_EQUAL_EQUAL, "==")                      \
+    X(SYM_NOT_EQUAL, "!=")                        \
+    X(SYM_LESS, "<")                              \
+    X(SYM_LESS_EQUAL, "<=")                       \
+    X(SYM_GREATER, ">")                           \
+    X(SYM_GREATER_EQUAL, ">=")                    \
+    X(SYM_TRUE, "True")                           \
+    X(SYM_FALSE, "False")                         \
+    X(SYM_FACTORIAL, "factorial")                 \
+    X(SYM_INFINITE_RECURSION, "infinite_recursion")
+
+typedef enum
+{
+#define WELL_KNOWN_SYMBOL_ENUM(symbol, text) symbol,
+    WELL_KNOWN_SYMBOLS(WELL_KNOWN_SYMBOL_ENUM)
+#undef WELL_KNOWN_SYMBOL_ENUM
+    SYM_WELL_KNOWN_COUNT
+} WellKnownSymbol;
+
+typedef struct InternChunk InternChunk;
+
+typedef struct
+{
+    const char **names; // names[symbol] is the interned text
+    uint32_t *lengths;  // lengths[symbol] is its length in bytes
+    uint32_t *hashes;   // hashes[symbol] caches its hash
+    uint32_t count;     // Number of symbols
+    uint32_t capacity;  // Allocated length of names, lengths and hashes
+    uint32_t *slots;    // Open-addressed hash table of symbol + 1 (0 = empty)
+    uint32_t slot_mask; // Number of slots minus one (a power of two)
+    InternChunk *chunk; // Chunk the next name is copied into
+} Interner;
+
+Interner *interner_create(void);
+void interner_free(Interner *interner);
+
+// Symbol for text[0..length), interning the text if it is new
+Symbol interner_intern(Interner *interner, const char *text, size_t length);
+
+const char *interner_name(const Interner *interner, Symbol symbol);
+
+// The process-wide interner shared by the lexer, parser and evaluators.
+// Created on first use.
+Interner *interner_global(void);
+
+// Shorthands for the global interner
+Symbol symbol_intern(const char *text, size_t length);
+Symbol symbol_intern_cstr(const char *name);
+const char *symbol_name(Symbol symbol);
+
+#endif // INTERN_H
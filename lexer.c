@@ -1,8 +1,44 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <ctype.h>
 #include <string.h>
 #include "lexer.h"
+#include "decimal.h"
+#include "scan.h"
+
+// Character classes. The lexer classifies bytes through this table rather
+// than <ctype.h>, so classification is a single load and does not depend on
+// the current locale. Bytes >= 0x80 have no class.
+enum
+{
+    CHAR_SPACE = 1 << 0,       // ' ', '\t', '\n', '\v', '\f', '\r'
+    CHAR_DIGIT = 1 << 1,       // '0'-'9'
+    CHAR_IDENT_START = 1 << 2, // letters and '_'
+    CHAR_IDENT = 1 << 3,       // letters, digits, '_' and '#'
+};
+
+#define SP CHAR_SPACE
+#define DG CHAR_DIGIT
+#define IS CHAR_IDENT_START
+#define ID CHAR_IDENT
+static const unsigned char char_class[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, SP, SP, SP, SP, SP, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    SP, 0, 0, ID, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    DG|ID, DG|ID, DG|ID, DG|ID, DG|ID, DG|ID, DG|ID, DG|ID, DG|ID, DG|ID, 0, 0, 0, 0, 0, 0,
+    0, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID,
+    IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, 0, 0, 0, 0, IS|ID,
+    0, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID,
+    IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, IS|ID, 0, 0, 0, 0, 0,
+};
+#undef SP
+#undef DG
+#undef IS
+#undef ID
+
+static inline int char_has_class(char c, unsigned char char_class_mask)
+{
+    return (char_class[(unsigned char)c] & char_class_mask) != 0;
+}
 
 const char *token_type_to_string(TokenType type)
 {
@@ -10,6 +46,8 @@ const char *token_type_to_string(TokenType type)
     {
     case TOKEN_NUMBER:
         return "Number";
+    case TOKEN_INTEGER:
+        return "Integer";
     case TOKEN_STRING:
         return "String";
     case TOKEN_PLUS:
@@ -89,31 +127,159 @@ const char *token_type_to_string(TokenType type)
     }
 }
 
+char *token_text_copy(const Token *token)
+{
+    char *copy = strndup(token->text, token->length);
+    if (!copy)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for token text\n");
+        exit(EXIT_FAILURE);
+    }
+    return copy;
+}
+
 Lexer lexer_create(const char *text)
+{
+    return lexer_create_with_length(text, strlen(text));
+}
+
+Lexer lexer_create_with_length(const char *text, size_t length)
 {
     Lexer lexer;
     lexer.text = text;
+    lexer.length = length;
     lexer.pos = 0;
-    lexer.current_char = lexer.text[lexer.pos];
+    lexer.current_char = length > 0 ? lexer.text[0] : '\0';
+    lexer.interner = interner_global();
+    lexer.stream = NULL;
+    lexer.buffer = NULL;
+    lexer.capacity = 0;
+    lexer.token_start = 0;
+    lexer.consumed = 0;
+    lexer.consumed_lines = 0;
+    lexer.consumed_line_start = 0;
+    lexer.strings = NULL;
     return lexer;
 }
 
-char lexer_peek(Lexer *lexer)
+Lexer lexer_create_stream(FILE *stream, size_t chunk_size)
 {
-    if (lexer->pos + 1 < strlen(lexer->text))
+    Lexer lexer = lexer_create_with_length("", 0);
+    lexer.capacity = chunk_size > 0 ? chunk_size : 1;
+    lexer.buffer = malloc(lexer.capacity);
+    if (!lexer.buffer)
     {
-        return lexer->text[lexer->pos + 1];
+        fprintf(stderr, "Error: Memory allocation failed for lexer buffer\n");
+        exit(EXIT_FAILURE);
     }
-    else
+    lexer.text = lexer.buffer;
+    lexer.stream = stream;
+    return lexer;
+}
+
+void lexer_destroy(Lexer *lexer)
+{
+    free(lexer->buffer);
+    arena_free(lexer->strings);
+    lexer->buffer = NULL;
+    lexer->stream = NULL;
+    lexer->strings = NULL;
+}
+
+// Streaming only: drop the text before token_start, then read more input
+// after the text still held. The buffer only grows when one token fills it.
+// Positions stay relative to the buffer, so pos and token_start shift down.
+// Returns 0 when there is no more input.
+static int lexer_refill(Lexer *lexer)
+{
+    if (!lexer->stream)
+    {
+        return 0;
+    }
+
+    size_t keep = lexer->token_start;
+    size_t held = lexer->length - keep;
+
+    // Remember where lines start in the text being dropped, so positions
+    // can still be reported once it is gone
+    const char *dropped_end = lexer->buffer + keep;
+    for (const char *p = scan_find_byte(lexer->buffer, dropped_end, '\n'); p < dropped_end;
+         p = scan_find_byte(p + 1, dropped_end, '\n'))
+    {
+        lexer->consumed_lines++;
+        lexer->consumed_line_start = lexer->consumed + (p + 1 - lexer->buffer);
+    }
+    lexer->consumed += keep;
+
+    memmove(lexer->buffer, lexer->buffer + keep, held);
+    lexer->pos -= keep;
+    lexer->token_start = 0;
+
+    if (held == lexer->capacity)
+    {
+        lexer->capacity *= 2;
+        char *grown = realloc(lexer->buffer, lexer->capacity);
+        if (!grown)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for lexer buffer\n");
+            exit(EXIT_FAILURE);
+        }
+        lexer->buffer = grown;
+    }
+
+    size_t read = fread(lexer->buffer + held, 1, lexer->capacity - held, lexer->stream);
+    if (read == 0)
+    {
+        if (ferror(lexer->stream))
+        {
+            fprintf(stderr, "Error: Failed to read program text\n");
+            exit(EXIT_FAILURE);
+        }
+        lexer->stream = NULL; // End of input; later refills are no-ops
+    }
+
+    lexer->text = lexer->buffer;
+    lexer->length = held + read;
+    lexer->current_char = lexer->pos < lexer->length ? lexer->text[lexer->pos] : '\0';
+    return read > 0;
+}
+
+// Skipped text is never part of a token, so a refill may discard it
+static int lexer_refill_after_skip(Lexer *lexer)
+{
+    lexer->token_start = lexer->pos;
+    return lexer_refill(lexer);
+}
+
+// Text that must outlive the next refill is copied when streaming. It is
+// kept out of the interner, which would grow with every distinct string
+// and renumber the symbols interned after it.
+static const char *lexer_stable_text(Lexer *lexer, const char *text, size_t length)
+{
+    if (!lexer->buffer)
+    {
+        return text;
+    }
+    if (!lexer->strings)
+    {
+        lexer->strings = arena_create(ARENA_DEFAULT_CHUNK_SIZE);
+    }
+    return arena_strndup(lexer->strings, text, length);
+}
+
+char lexer_peek(Lexer *lexer)
+{
+    if (lexer->pos + 1 >= lexer->length && !lexer_refill(lexer))
     {
         return '\0';
     }
+    return lexer->text[lexer->pos + 1];
 }
 
 void lexer_advance(Lexer *lexer)
 {
     lexer->pos++;
-    if (lexer->pos < strlen(lexer->text))
+    if (lexer->pos < lexer->length)
     {
         lexer->current_char = lexer->text[lexer->pos];
     }
@@ -123,380 +289,482 @@ void lexer_advance(Lexer *lexer)
     }
 }
 
-void lexer_skip_whitespace(Lexer *lexer)
+// Move the lexer to `pos`, which may be anywhere up to the end of the input
+static void lexer_jump(Lexer *lexer, size_t pos)
 {
-    while (lexer->current_char != '\0' && isspace(lexer->current_char))
+    lexer->pos = pos;
+    lexer->current_char = pos < lexer->length ? lexer->text[pos] : '\0';
+}
+
+SourcePosition lexer_position(const Lexer *lexer, size_t offset)
+{
+    if (offset < lexer->consumed || offset > lexer->consumed + lexer->length)
+    {
+        return (SourcePosition){0, 0};
+    }
+    // Count the lines still in the buffer and add those already dropped
+    size_t in_buffer = offset - lexer->consumed;
+    SourcePosition position = source_position_scan(lexer->text, in_buffer);
+    if (position.line == 1)
     {
-        lexer_advance(lexer);
+        position.column = offset - lexer->consumed_line_start + 1;
     }
+    position.line += lexer->consumed_lines;
+    return position;
 }
 
-void lexer_skip_single_line_comment(Lexer *lexer)
+// Report a lexical error at byte `offset` of the input and exit
+static _Noreturn void lexer_error(const Lexer *lexer, size_t offset, const char *message)
 {
-    // Skip the '--' characters
-    lexer_advance(lexer); // Skip first '-'
-    lexer_advance(lexer); // Skip second '-'
-    
-    // Skip until end of line or end of input
-    while (lexer->current_char != '\0' && lexer->current_char != '\n')
+    SourcePosition position = lexer_position(lexer, offset);
+    if (position.line > 0)
+    {
+        fprintf(stderr, "Error: %s at line %zu, column %zu\n", message, position.line, position.column);
+    }
+    else
     {
-        lexer_advance(lexer);
+        fprintf(stderr, "Error: %s at byte %zu\n", message, offset);
     }
+    exit(EXIT_FAILURE);
+}
+
+void lexer_seek(Lexer *lexer, size_t pos)
+{
+    lexer_jump(lexer, pos);
+    lexer->token_start = pos;
+}
+
+// Build a token covering the source from token_start to the current position
+static Token lexer_token(Lexer *lexer, TokenType type)
+{
+    return (Token){type, {0}, lexer->text + lexer->token_start, lexer->pos - lexer->token_start, 0};
+}
+
+void lexer_skip_whitespace(Lexer *lexer)
+{
+    do
+    {
+        const char *end = lexer->text + lexer->length;
+        const char *p = scan_skip_space(lexer->text + lexer->pos, end);
+        lexer_jump(lexer, p - lexer->text);
+    } while (lexer->pos == lexer->length && lexer_refill_after_skip(lexer));
+}
+
+void lexer_skip_single_line_comment(Lexer *lexer)
+{
+    // Skip the '--' characters, then jump to the end of line or end of input
+    lexer_jump(lexer, lexer->pos + 2);
+    do
+    {
+        const char *end = lexer->text + lexer->length;
+        const char *p = scan_find_byte(lexer->text + lexer->pos, end, '\n');
+        lexer_jump(lexer, p - lexer->text);
+    } while (lexer->pos == lexer->length && lexer_refill_after_skip(lexer));
 }
 
 void lexer_skip_multi_line_comment(Lexer *lexer)
 {
-    // Skip the '{-' characters
-    lexer_advance(lexer); // Skip '{'
-    lexer_advance(lexer); // Skip '-'
-    
-    // Track nesting level for nested comments
+    const char *end = lexer->text + lexer->length;
+    const char *p = lexer->text + lexer->pos + 2; // Skip the '{-' characters
+
+    // Track nesting level for nested comments. Only '{' and '-' can start
+    // a delimiter, so jump straight from one candidate to the next.
     int nesting_level = 1;
-    
-    while (lexer->current_char != '\0' && nesting_level > 0)
+
+    while (nesting_level > 0)
     {
-        if (lexer->current_char == '{' && lexer_peek(lexer) == '-')
+        p = scan_find_either(p, end, '{', '-');
+        if (p + 1 >= end)
+        {
+            // A delimiter may straddle the end of the buffer; keep its
+            // first byte and read more input when streaming
+            lexer_jump(lexer, p - lexer->text);
+            if (lexer_refill_after_skip(lexer))
+            {
+                end = lexer->text + lexer->length;
+                p = lexer->text + lexer->pos;
+                continue;
+            }
+            // Unterminated comment runs to the end of input
+            p = lexer->text + lexer->length;
+            break;
+        }
+        if (p[0] == '{' && p[1] == '-')
         {
             // Found opening of nested comment
-            lexer_advance(lexer); // Skip '{'
-            lexer_advance(lexer); // Skip '-'
             nesting_level++;
+            p += 2;
         }
-        else if (lexer->current_char == '-' && lexer_peek(lexer) == '}')
+        else if (p[0] == '-' && p[1] == '}')
         {
             // Found closing of comment
-            lexer_advance(lexer); // Skip '-'
-            lexer_advance(lexer); // Skip '}'
             nesting_level--;
+            p += 2;
         }
         else
         {
-            lexer_advance(lexer);
+            p++;
         }
     }
+
+    lexer_jump(lexer, p - lexer->text);
 }
 
 Token lexer_get_number(Lexer *lexer)
 {
-    char buffer[64];
-    int i = 0;
-
-    while (lexer->current_char != '\0' && (isdigit(lexer->current_char) || lexer->current_char == '.'))
+    // Find the extent of the literal in one pass over the source
+    lexer->token_start = lexer->pos;
+    int has_point = 0;
+    do
+    {
+        const char *end = lexer->text + lexer->length;
+        const char *p = lexer->text + lexer->pos;
+        while (p < end && (char_has_class(*p, CHAR_DIGIT) || *p == '.'))
+        {
+            has_point |= *p == '.';
+            p++;
+        }
+        lexer_jump(lexer, p - lexer->text);
+    } while (lexer->pos == lexer->length && lexer_refill(lexer));
+    const char *start = lexer->text + lexer->token_start;
+    size_t length = lexer->pos - lexer->token_start;
+
+    // Convert straight from the source slice. Integral literals keep an
+    // exact 64-bit value unless they overflow it.
+    Token token = {TOKEN_INTEGER, {0}, start, length, 0};
+    if (!has_point && decimal_parse_int64(start, length, &token.integer))
     {
-        buffer[i++] = lexer->current_char;
-        lexer_advance(lexer);
+        return token;
     }
-    buffer[i] = '\0';
-
-    Token token;
     token.type = TOKEN_NUMBER;
-    token.value = atof(buffer);
+    if (!decimal_parse(start, length, &token.value))
+    {
+        char message[64];
+        snprintf(message, sizeof(message), "Malformed number literal '%.*s%s'", length > 32 ? 32 : (int)length, start,
+                 length > 32 ? "..." : "");
+        lexer_error(lexer, lexer->consumed + lexer->token_start, message);
+    }
     return token;
 }
 
 Token lexer_get_string(Lexer *lexer)
 {
+    lexer->token_start = lexer->pos;
     lexer_advance(lexer); // Skip the opening quote
 
-    char buffer[1024]; // Adjust size as needed
-    int length = 0;
-
-    while (lexer->current_char != '"' && lexer->current_char != '\0')
-    {
-        buffer[length++] = lexer->current_char;
-        lexer_advance(lexer);
-    }
-
-    if (lexer->current_char == '\0')
+    // The token text is the slice between the quotes, found with one scan
+    for (;;)
     {
-        fprintf(stderr, "Error: Unterminated string literal\n");
-        exit(EXIT_FAILURE);
+        const char *end = lexer->text + lexer->length;
+        const char *quote = scan_find_byte(lexer->text + lexer->pos, end, '"');
+        lexer_jump(lexer, quote - lexer->text);
+        if (quote < end)
+        {
+            break;
+        }
+        if (!lexer_refill(lexer))
+        {
+            lexer_error(lexer, lexer->consumed + lexer->token_start, "Unterminated string literal");
+        }
     }
 
-    buffer[length] = '\0';
+    const char *start = lexer->text + lexer->token_start + 1;
+    size_t length = lexer->pos - lexer->token_start - 1;
     lexer_advance(lexer); // Skip the closing quote
 
     // Return the string token
-    return (Token){TOKEN_STRING, 0, strdup(buffer)};
+    return (Token){TOKEN_STRING, {0}, lexer_stable_text(lexer, start, length), length, 0};
 }
 
-Token lexer_get_next_token(Lexer *lexer)
+static Token lexer_scan_token(Lexer *lexer)
 {
-    while (lexer->current_char != '\0')
+    for (;;)
     {
-        if (isspace(lexer->current_char))
+        lexer->token_start = lexer->pos;
+        if (lexer->pos == lexer->length && !lexer_refill(lexer))
         {
-            lexer_skip_whitespace(lexer);
-            continue;
+            break;
         }
-        if (isdigit(lexer->current_char) || 
-            (lexer->current_char == '.' && isdigit(lexer_peek(lexer))))
+
+        // One switch on the current byte selects the token handler; letters
+        // and bytes without a token of their own fall through to default
+        switch (lexer->current_char)
         {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\v':
+        case '\f':
+        case '\r':
+            lexer_skip_whitespace(lexer);
+            continue;
+
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
             return lexer_get_number(lexer);
-        }
-        if (lexer->current_char == '"')
-        {
+
+        case '"':
             return lexer_get_string(lexer);
-        }
-        if (lexer->current_char == '+')
-        {
-            lexer_advance(lexer);
-            return (Token){TOKEN_PLUS, 0, NULL};
-        }
-        if (lexer->current_char == '*')
-        {
+
+        case '+':
             lexer_advance(lexer);
-            return (Token){TOKEN_MUL, 0, NULL};
-        }
-        if (lexer->current_char == '/')
-        {
+            return lexer_token(lexer, TOKEN_PLUS);
+
+        case '*':
             lexer_advance(lexer);
-            return (Token){TOKEN_DIV, 0, NULL};
-        }
-        if (lexer->current_char == '(')
-        {
+            return lexer_token(lexer, TOKEN_MUL);
+
+        case '/':
             lexer_advance(lexer);
-            return (Token){TOKEN_LPAREN, 0, NULL};
-        }
-        if (lexer->current_char == ')')
-        {
+            return lexer_token(lexer, TOKEN_DIV);
+
+        case '(':
             lexer_advance(lexer);
-            return (Token){TOKEN_RPAREN, 0, NULL};
-        }
+            return lexer_token(lexer, TOKEN_LPAREN);
 
-        // Idenitifier or keywords
-        if (isalpha(lexer->current_char) || lexer->current_char == '_')
-        {
-            return lexer_get_identifier(lexer);
-        }
+        case ')':
+            lexer_advance(lexer);
+            return lexer_token(lexer, TOKEN_RPAREN);
 
         // Handle '|'
-        if (lexer->current_char == '|')
-        {
+        case '|':
             lexer_advance(lexer);
-            return (Token){TOKEN_PIPE, 0, NULL};
-        }
+            return lexer_token(lexer, TOKEN_PIPE);
 
         // Handle '\' (backslash for lambda)
-        if (lexer->current_char == '\\')
-        {
+        case '\\':
             lexer_advance(lexer);
-            return (Token){TOKEN_BACKSLASH, 0, NULL};
-        }
+            return lexer_token(lexer, TOKEN_BACKSLASH);
 
-        // Handle '.' (dot)
-        if (lexer->current_char == '.')
-        {
+        // Handle '.' (dot) and numbers with a leading '.'
+        case '.':
+            if (char_has_class(lexer_peek(lexer), CHAR_DIGIT))
+            {
+                return lexer_get_number(lexer);
+            }
             lexer_advance(lexer);
-            return (Token){TOKEN_DOT, 0, NULL};
-        }
+            return lexer_token(lexer, TOKEN_DOT);
 
-        // Handle '{', '{-', and '}'
-        if (lexer->current_char == '{')
-        {
-            if (lexer->text[lexer->pos + 1] == '-')
+        // Handle '{', '{-'
+        case '{':
+            if (lexer_peek(lexer) == '-')
             {
                 // Multi-line comment '{-'
                 lexer_skip_multi_line_comment(lexer);
                 continue; // Skip to next token
             }
-            else
-            {
-                lexer_advance(lexer);
-                return (Token){TOKEN_LBRACE, 0, NULL};
-            }
-        }
-        if (lexer->current_char == '}')
-        {
             lexer_advance(lexer);
-            return (Token){TOKEN_RBRACE, 0, NULL};
-        }
+            return lexer_token(lexer, TOKEN_LBRACE);
+
+        case '}':
+            lexer_advance(lexer);
+            return lexer_token(lexer, TOKEN_RBRACE);
 
         // Handle '-', '--', and '->'
-        if (lexer->current_char == '-')
-        {
-            if (lexer->text[lexer->pos + 1] == '>')
+        case '-':
+            if (lexer_peek(lexer) == '>')
             {
                 lexer_advance(lexer); // Skip '-'
                 lexer_advance(lexer); // Skip '>'
-                return (Token){TOKEN_ARROW, 0, NULL};
+                return lexer_token(lexer, TOKEN_ARROW);
             }
-            else if (lexer->text[lexer->pos + 1] == '-')
+            else if (lexer_peek(lexer) == '-')
             {
                 // Single-line comment '--'
                 lexer_skip_single_line_comment(lexer);
                 continue; // Skip to next token
             }
-            else
-            {
-                // Handle minus operator
-                lexer_advance(lexer);
-                return (Token){TOKEN_MINUS, 0, NULL};
-            }
-        }
+            // Handle minus operator
+            lexer_advance(lexer);
+            return lexer_token(lexer, TOKEN_MINUS);
 
         // Comma ','
-        if (lexer->current_char == ',')
-        {
+        case ',':
             lexer_advance(lexer);
-            return (Token){TOKEN_COMMA, 0, NULL};
-        }
+            return lexer_token(lexer, TOKEN_COMMA);
 
         // Semicolon ';'
-        if (lexer->current_char == ';')
-        {
+        case ';':
             lexer_advance(lexer);
-            return (Token){TOKEN_SEMICOLON, 0, NULL};
-        }
+            return lexer_token(lexer, TOKEN_SEMICOLON);
 
-        // Equal '='
-        if (lexer->current_char == '=')
-        {
+        // Equal '=', '==' and '=>'
+        case '=':
             if (lexer_peek(lexer) == '=')
             {
                 lexer_advance(lexer); // Skip '='
                 lexer_advance(lexer); // Skip second '='
-                return (Token){TOKEN_EQUAL_EQUAL, 0, NULL};
+                return lexer_token(lexer, TOKEN_EQUAL_EQUAL);
             }
-            // Handle '=>' (FAT_ARROW)
             else if (lexer_peek(lexer) == '>')
             {
                 lexer_advance(lexer); // Skip '='
                 lexer_advance(lexer); // Skip '>'
-                return (Token){TOKEN_FAT_ARROW, 0, NULL};
-            }
-            else
-            {
-                lexer_advance(lexer);
-                return (Token){TOKEN_EQUAL, 0, NULL};
+                return lexer_token(lexer, TOKEN_FAT_ARROW);
             }
-        }
+            lexer_advance(lexer);
+            return lexer_token(lexer, TOKEN_EQUAL);
 
-        if (lexer->current_char == '!')
-        {
+        case '!':
             if (lexer_peek(lexer) == '=')
             {
                 lexer_advance(lexer); // Skip '!'
                 lexer_advance(lexer); // Skip '='
-                return (Token){TOKEN_NOT_EQUAL, 0, NULL};
+                return lexer_token(lexer, TOKEN_NOT_EQUAL);
             }
-            else
-            {
-                fprintf(stderr, "Error: Unexpected character '!'\n");
-                exit(EXIT_FAILURE);
-            }
-        }
+            lexer_error(lexer, lexer->consumed + lexer->pos, "Unexpected character '!'");
 
-        if (lexer->current_char == '<')
-        {
+        case '<':
             if (lexer_peek(lexer) == '=')
             {
                 lexer_advance(lexer); // Skip '<'
                 lexer_advance(lexer); // Skip '='
-                return (Token){TOKEN_LESS_EQUAL, 0, NULL};
+                return lexer_token(lexer, TOKEN_LESS_EQUAL);
             }
-            else
-            {
-                lexer_advance(lexer);
-                return (Token){TOKEN_LESS, 0, NULL};
-            }
-        }
+            lexer_advance(lexer);
+            return lexer_token(lexer, TOKEN_LESS);
 
-        if (lexer->current_char == '>')
-        {
+        case '>':
             if (lexer_peek(lexer) == '=')
             {
                 lexer_advance(lexer); // Skip '>'
                 lexer_advance(lexer); // Skip '='
-                return (Token){TOKEN_GREATER_EQUAL, 0, NULL};
+                return lexer_token(lexer, TOKEN_GREATER_EQUAL);
             }
-            else
+            lexer_advance(lexer);
+            return lexer_token(lexer, TOKEN_GREATER);
+
+        default:
+            // Identifier or keywords
+            if (char_has_class(lexer->current_char, CHAR_IDENT_START))
             {
-                lexer_advance(lexer);
-                return (Token){TOKEN_GREATER, 0, NULL};
+                return lexer_get_identifier(lexer);
             }
+            char message[32];
+            snprintf(message, sizeof(message), "Unknown character '%c'", lexer->current_char);
+            lexer_error(lexer, lexer->consumed + lexer->pos, message);
         }
-
-        fprintf(stderr, "Error: Unknown character '%c'\n", lexer->current_char);
-        exit(EXIT_FAILURE);
     }
 
-    return (Token){TOKEN_EOF, 0, NULL};
+    return lexer_token(lexer, TOKEN_EOF);
+}
+
+Token lexer_get_next_token(Lexer *lexer)
+{
+    Token token = lexer_scan_token(lexer);
+    // Every path leaves token_start at the token's first byte
+    token.offset = lexer->consumed + lexer->token_start;
+    return token;
 }
 
 int is_identifier_char(char c)
 {
-    return isalnum(c) || c == '_' || c == '#';
+    return char_has_class(c, CHAR_IDENT);
 }
 
-Token lexer_get_identifier(Lexer *lexer)
+// Returns `type` if the slice spells `keyword` (whose length the caller has
+// already matched), otherwise TOKEN_IDENTIFIER
+static TokenType keyword_match(const char *text, const char *keyword, size_t length, TokenType type)
 {
-    char buffer[64];
-    int i = 0;
+    return memcmp(text, keyword, length) == 0 ? type : TOKEN_IDENTIFIER;
+}
 
-    while (lexer->current_char != '\0' && is_identifier_char(lexer->current_char))
+// Classify an identifier slice as a keyword or TOKEN_IDENTIFIER.
+// Dispatches on length and then on the first character, so at most one
+// memcmp runs no matter how many keywords exist. Keep this in sync with
+// token_type_to_string when adding keywords.
+static TokenType lexer_keyword_type(const char *text, size_t length)
+{
+    switch (length)
     {
-        buffer[i++] = lexer->current_char;
-        lexer_advance(lexer);
+    case 2:
+        switch (text[0])
+        {
+        case 'i':
+            if (text[1] == 'n')
+                return TOKEN_KEYWORD_IN;
+            if (text[1] == 'f')
+                return TOKEN_KEYWORD_IF;
+            return TOKEN_IDENTIFIER;
+        case 'o':
+            return keyword_match(text, "of", 2, TOKEN_KEYWORD_OF);
+        }
+        break;
+    case 3:
+        switch (text[0])
+        {
+        case 'e':
+            return keyword_match(text, "end", 3, TOKEN_KEYWORD_END);
+        case 'f':
+            return keyword_match(text, "fun", 3, TOKEN_KEYWORD_FUN);
+        case 'l':
+            return keyword_match(text, "let", 3, TOKEN_KEYWORD_LET);
+        }
+        break;
+    case 4:
+        switch (text[0])
+        {
+        case 'c':
+            return keyword_match(text, "case", 4, TOKEN_KEYWORD_CASE);
+        case 'e':
+            return keyword_match(text, "else", 4, TOKEN_KEYWORD_ELSE);
+        case 't':
+            // "type" and "then" share length and first character
+            if (text[1] == 'y')
+                return keyword_match(text, "type", 4, TOKEN_TYPE);
+            return keyword_match(text, "then", 4, TOKEN_KEYWORD_THEN);
+        }
+        break;
+    case 6:
+        switch (text[0])
+        {
+        case 'N':
+            return keyword_match(text, "Number", 6, TOKEN_TYPE_NUMBER);
+        case 'S':
+            return keyword_match(text, "String", 6, TOKEN_TYPE_STRING);
+        }
+        break;
     }
-    buffer[i] = '\0';
+    return TOKEN_IDENTIFIER;
+}
 
-    // Check for keywords
-    if (strcmp(buffer, "type") == 0)
-    {
-        return (Token){TOKEN_TYPE, 0, NULL};
-    }
-    if (strcmp(buffer, "Number") == 0)
-    {
-        return (Token){TOKEN_TYPE_NUMBER, 0, NULL};
-    }
-    else if (strcmp(buffer, "String") == 0)
-    {
-        return (Token){TOKEN_TYPE_STRING, 0, NULL};
-    }
-    else if (strcmp(buffer, "fun") == 0)
-    {
-        return (Token){TOKEN_KEYWORD_FUN, 0, NULL};
-    }
-    else if (strcmp(buffer, "let") == 0)
-    {
-        return (Token){TOKEN_KEYWORD_LET, 0, NULL};
-    }
-    else if (strcmp(buffer, "in") == 0)
-    {
-        return (Token){TOKEN_KEYWORD_IN, 0, NULL};
-    }
-    else if (strcmp(buffer, "end") == 0)
-    {
-        return (Token){TOKEN_KEYWORD_END, 0, NULL};
-    }
-    else if (strcmp(buffer, "if") == 0)
-    {
-        return (Token){TOKEN_KEYWORD_IF, 0, NULL};
-    }
-    else if (strcmp(buffer, "then") == 0)
-    {
-        return (Token){TOKEN_KEYWORD_THEN, 0, NULL};
-    }
-    else if (strcmp(buffer, "else") == 0)
-    {
-        return (Token){TOKEN_KEYWORD_ELSE, 0, NULL};
-    }
-    else if (strcmp(buffer, "case") == 0)
+Token lexer_get_identifier(Lexer *lexer)
+{
+    lexer->token_start = lexer->pos;
+    do
     {
-        return (Token){TOKEN_KEYWORD_CASE, 0, NULL};
-    }
-    else if (strcmp(buffer, "of") == 0)
+        const char *end = lexer->text + lexer->length;
+        const char *p = lexer->text + lexer->pos;
+        while (p < end && char_has_class(*p, CHAR_IDENT))
+        {
+            p++;
+        }
+        lexer_jump(lexer, p - lexer->text);
+    } while (lexer->pos == lexer->length && lexer_refill(lexer));
+    const char *text = lexer->text + lexer->token_start;
+    size_t length = lexer->pos - lexer->token_start;
+
+    TokenType type = lexer_keyword_type(text, length);
+    if (type != TOKEN_IDENTIFIER)
     {
-        return (Token){TOKEN_KEYWORD_OF, 0, NULL};
+        return (Token){type, {0}, text, length, 0};
     }
-    else
+
+    // It's an identifier; the token carries its interned symbol and points
+    // at its name in the source (or, when streaming, in the interner)
+    Token token = {TOKEN_IDENTIFIER, {0}, text, length, 0};
+    token.symbol = interner_intern(lexer->interner, text, length);
+    if (lexer->buffer)
     {
-        // It's an identifier
-        Token token;
-        token.type = TOKEN_IDENTIFIER;
-        token.value = 0;
-        token.text = strdup(buffer); // Store the identifier name
-        return token;
+        token.text = interner_name(lexer->interner, token.symbol);
     }
+    return token;
 }
@@ -1,11 +1,17 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include "arena.h"
+#include "intern.h"
+#include "line_index.h"
 
 typedef enum
 {
-    TOKEN_NUMBER,
+    TOKEN_NUMBER,  // Literal with a decimal point (or too large for TOKEN_INTEGER)
+    TOKEN_INTEGER, // Literal made only of digits that fits in int64_t
     TOKEN_STRING,
     TOKEN_PLUS,   // '+'
     TOKEN_MINUS,  // '-'
@@ -48,21 +54,65 @@ typedef enum
 typedef struct
 {
     TokenType type;
-    double value; // Used if type is TOKEN_NUMBER
-    char *text;   // Used if type is TOKEN_IDENTIFIER or keyword
+    union
+    {
+        double value;    // Used if type is TOKEN_NUMBER
+        int64_t integer; // Used if type is TOKEN_INTEGER
+        Symbol symbol;   // Used if type is TOKEN_IDENTIFIER
+    };
+    const char *text; // Slice of the source covered by the token (for TOKEN_STRING, the part between the quotes)
+    size_t length;    // Length of the slice (text is not NUL-terminated)
+    size_t offset;    // Byte offset of the token's first byte (a string's opening quote) in the whole input
 } Token;
 
+// Default chunk size for lexer_create_stream
+#define LEXER_STREAM_CHUNK_SIZE (64 * 1024)
+
 typedef struct
 {
     const char *text;
+    size_t length; // Number of bytes in text; scanning never reads past it
     size_t pos;
     char current_char;
+    Interner *interner; // Where identifiers are interned (the global interner by default)
+
+    // Streaming input. `buffer` is non-NULL for a lexer made by
+    // lexer_create_stream; `text` then points into it and holds only the
+    // current chunk, and positions are relative to the chunk.
+    FILE *stream;               // Source of further input (NULL once exhausted)
+    char *buffer;               // Owned chunk buffer
+    size_t capacity;            // Allocated size of buffer
+    size_t token_start;         // Start of the token being lexed; kept across refills
+    size_t consumed;            // Input bytes dropped before text[0]
+    size_t consumed_lines;      // Newlines among them
+    size_t consumed_line_start; // Input offset of the line start after the last of them
+    Arena *strings;             // Copies of string literal text, made on first use
 } Lexer;
 
 const char *token_type_to_string(TokenType type);
 
+// Copy a token's text into a NUL-terminated heap string owned by the caller
+char *token_text_copy(const Token *token);
+
 Lexer lexer_create(const char *text);
+Lexer lexer_create_with_length(const char *text, size_t length);
+
+// Lex from `stream`, reading it `chunk_size` bytes at a time, so memory use
+// is bounded by the longest token rather than the size of the input. The
+// buffer only grows when a single token does not fit in it.
+// Identifier text is interned and string text is copied into the lexer, so
+// both stay valid until lexer_destroy; the text of every other token is
+// only valid until the next call into the lexer.
+Lexer lexer_create_stream(FILE *stream, size_t chunk_size);
+void lexer_destroy(Lexer *lexer);
 char lexer_peek(Lexer *lexer);
+
+// Line and column of input offset `offset`, found by scanning only when
+// asked. When streaming, offsets before the current chunk are unknown.
+SourcePosition lexer_position(const Lexer *lexer, size_t offset);
+// Continue lexing in-memory text from `pos`, which must not be inside a
+// token or comment
+void lexer_seek(Lexer *lexer, size_t pos);
 void lexer_advance(Lexer *lexer);
 void lexer_skip_whitespace(Lexer *lexer);
 void lexer_skip_single_line_comment(Lexer *lexer);
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "line_index.h"
+#include "scan.h"
+
+LineIndex *line_index_build(const char *text, size_t length)
+{
+    LineIndex *index = malloc(sizeof(LineIndex));
+    size_t capacity = 64;
+    size_t *starts = malloc(capacity * sizeof(size_t));
+    if (!index || !starts)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for line index\n");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t count = 0;
+    starts[count++] = 0;
+    const char *end = text + length;
+    for (const char *p = scan_find_byte(text, end, '\n'); p < end; p = scan_find_byte(p + 1, end, '\n'))
+    {
+        if (count == capacity)
+        {
+            capacity *= 2;
+            size_t *grown = realloc(starts, capacity * sizeof(size_t));
+            if (!grown)
+            {
+                fprintf(stderr, "Error: Memory allocation failed for line index\n");
+                exit(EXIT_FAILURE);
+            }
+            starts = grown;
+        }
+        starts[count++] = p + 1 - text;
+    }
+
+    index->starts = starts;
+    index->count = count;
+    return index;
+}
+
+void line_index_free(LineIndex *index)
+{
+    if (!index)
+        return;
+    free(index->starts);
+    free(index);
+}
+
+SourcePosition line_index_lookup(const LineIndex *index, size_t offset)
+{
+    // Last line that starts at or before offset
+    size_t low = 0, high = index->count - 1;
+    while (low < high)
+    {
+        size_t mid = high - (high - low) / 2;
+        if (index->starts[mid] <= offset)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+    return (SourcePosition){low + 1, offset - index->starts[low] + 1};
+}
+
+SourcePosition source_position_scan(const char *text, size_t offset)
+{
+    SourcePosition position = {1, 1};
+    size_t line_start = 0;
+    const char *end = text + offset;
+    for (const char *p = scan_find_byte(text, end, '\n'); p < end; p = scan_find_byte(p + 1, end, '\n'))
+    {
+        position.line++;
+        line_start = p + 1 - text;
+    }
+    position.column = offset - line_start + 1;
+    return position;
+}
@@ -0,0 +1,35 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <stddef.h>
+
+// Source positions
+// ================
+// Tokens carry only byte offsets, so lexing never counts lines. When a
+// diagnostic needs a line and column, the offsets of the line starts are
+// found with one newline scan and looked up by binary search.
+
+// 1-based line and byte column; line 0 means the position is unknown
+typedef struct
+{
+    size_t line;
+    size_t column;
+} SourcePosition;
+
+typedef struct
+{
+    size_t *starts; // Offset of the first byte of each line, ascending
+    size_t count;   // Number of lines (at least 1)
+} LineIndex;
+
+LineIndex *line_index_build(const char *text, size_t length);
+void line_index_free(LineIndex *index);
+
+// Position of byte `offset` in the text the index was built from
+SourcePosition line_index_lookup(const LineIndex *index, size_t offset);
+
+// Position of byte `offset` in text[0..offset), counted in one scan
+// without building an index; for a single lookup
+SourcePosition source_position_scan(const char *text, size_t offset);
+
+#endif // LINE_INDEX_H
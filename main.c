@@ -6,25 +6,115 @@
 #include "evaluator.h"
 #include "symbol_table.h"
 #include "core.h"
+#include "core_flat.h"
+#include "core_cache.h"
+#include "source.h"
+#include "parallel_lex.h"
+#include "parallel_parse.h"
 
 void print_usage(const char *program_name) {
     printf("Usage: %s [OPTIONS] [FILE]\n", program_name);
     printf("Options:\n");
-    printf("  --ast, -a    Print AST instead of evaluating\n");
-    printf("  --help, -h   Show this help message\n");
-    printf("\nIf no FILE is specified, reads from stdin.\n");
+    printf("  --ast, -a           Print AST instead of evaluating\n");
+    printf("  --compile, -c       Write the parsed program to a .langc cache file\n");
+    printf("  --output FILE, -o   Cache file to write (default: FILE with a .langc suffix)\n");
+    printf("  --jobs N, -j N      Lex and parse large files on N threads (default: all processors)\n");
+    printf("  --share, -s         Share identical subexpressions of the parsed program\n");
+    printf("  --lazy, -l          Parse a function's body only when it is first called\n");
+    printf("  --help, -h          Show this help message\n");
+    printf("\nIf no FILE is specified, reads from stdin. A FILE written by --compile\n");
+    printf("is loaded without lexing or parsing and rebuilt into a tree to evaluate.\n");
+    printf("With --lazy, syntax errors in a function body are reported when the\n");
+    printf("function is first called.\n");
+}
+
+// Lex and parse the program into the current Core arena
+static CoreExpr *parse_program(Source *source, int jobs, int lazy) {
+    Parser parser;
+    TokenBuffer *tokens = NULL;
+    // Declare the built-in constructors before lexing interns anything, so
+    // symbols are numbered alike whether the source is lexed up front or
+    // as it streams in, and a cache built from either is the same
+    core_constructor_count();
+    if (source->text) {
+        // Lex the whole program up front, then parse from the token buffer
+        tokens = lexer_tokenize_parallel(source->text, source->length, jobs);
+        parser = parser_create_from_tokens(tokens);
+        // Lazy bodies are parsed later from the mapped text
+        parser.lazy_lambdas = lazy;
+    } else {
+        // The length of a pipe is unknown, so lex it as it arrives
+        FILE *stream = source->stream ? source->stream : stdin;
+        parser = parser_create(lexer_create_stream(stream, LEXER_STREAM_CHUNK_SIZE));
+    }
+    
+    // Type declarations at the beginning declare their constructors
+    while (parser.current_token.type == TOKEN_TYPE) {
+        parse_core_type_declaration(&parser);
+    }
+    
+    // Parse as Core expression instead of ML statements, with the
+    // top-level bindings of a large program parsed on `jobs` threads
+    CoreExpr *core_expr = parse_core_expression_parallel(&parser, jobs);
+
+    // Allow leftover tokens (type definitions might leave some)
+    // Don't require EOF for programs with type definitions
+
+    // The Core tree holds its own copies of names and strings
+    token_buffer_free(tokens);
+    lexer_destroy(&parser.lexer);
+    return core_expr;
+}
+
+// foo.lang -> foo.langc, anything else -> name.langc
+static char *cache_filename(const char *filename) {
+    size_t length = strlen(filename);
+    size_t stem = length;
+    if (length >= 5 && strcmp(filename + length - 5, ".lang") == 0) {
+        stem = length - 5;
+    }
+    char *result = malloc(stem + sizeof(".langc"));
+    if (!result) {
+        fprintf(stderr, "Error: Memory allocation failed for file name\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(result, filename, stem);
+    strcpy(result + stem, ".langc");
+    return result;
 }
 
 int main(int argc, char *argv[])
 {
-    char *program_text;
     int print_ast = 0;
+    int compile = 0;
+    int share = 0;
+    int lazy = 0;
+    const char *output = NULL;
+    int jobs = parallel_lex_default_threads();
     char *filename = NULL;
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--ast") == 0 || strcmp(argv[i], "-a") == 0) {
             print_ast = 1;
+        } else if (strcmp(argv[i], "--compile") == 0 || strcmp(argv[i], "-c") == 0) {
+            compile = 1;
+        } else if (strcmp(argv[i], "--output") == 0 || strcmp(argv[i], "-o") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s needs a file name\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--jobs") == 0 || strcmp(argv[i], "-j") == 0) {
+            if (i + 1 >= argc || atoi(argv[i + 1]) < 1) {
+                fprintf(stderr, "Error: %s needs a positive thread count\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            jobs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--share") == 0 || strcmp(argv[i], "-s") == 0) {
+            share = 1;
+        } else if (strcmp(argv[i], "--lazy") == 0 || strcmp(argv[i], "-l") == 0) {
+            lazy = 1;
         } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             print_usage(argv[0]);
             return EXIT_SUCCESS;
@@ -37,73 +127,89 @@ int main(int argc, char *argv[])
         }
     }
     
-    if (filename) {
-        // Read from file
-        FILE *file = fopen(filename, "r");
-        if (!file) {
-            fprintf(stderr, "Error: Cannot open file %s\n", filename);
-            return EXIT_FAILURE;
-        }
-        
-        fseek(file, 0, SEEK_END);
-        long length = ftell(file);
-        fseek(file, 0, SEEK_SET);
-        program_text = malloc(length + 1);
-        if (!program_text) {
-            fprintf(stderr, "Error: Memory allocation failed for program text\n");
-            fclose(file);
-            return EXIT_FAILURE;
-        }
-        fread(program_text, 1, length, file);
-        program_text[length] = '\0';
-        fclose(file);
-    } else {
-        // Read from stdin
-        fseek(stdin, 0, SEEK_END);
-        long length = ftell(stdin);
-        fseek(stdin, 0, SEEK_SET);
-        program_text = malloc(length + 1);
-        if (!program_text) {
-            fprintf(stderr, "Error: Memory allocation failed for program text\n");
-            return EXIT_FAILURE;
-        }
-        fread(program_text, 1, length, stdin);
-        program_text[length] = '\0';
+    // Map the file if possible; pipes and stdin are lexed as a stream
+    Source source = {0};
+    if (filename && !source_open(&source, filename)) {
+        fprintf(stderr, "Error: Cannot open file %s\n", filename);
+        return EXIT_FAILURE;
     }
 
-    // Initialize lexer and parser
-    Lexer lexer = lexer_create(program_text);
-    Parser parser = parser_create(lexer);
-    
-    // Skip any type definitions at the beginning
-    while (parser.current_token.type == TOKEN_TYPE) {
-        // Skip until we find the next expression (let, identifier, etc.)
-        while (parser.current_token.type != TOKEN_EOF && 
-               parser.current_token.type != TOKEN_KEYWORD_LET) {
-            parser.current_token = lexer_get_next_token(&parser.lexer);
-        }
+    if (compile && !output && !filename) {
+        fprintf(stderr, "Error: --compile reading stdin needs --output\n");
+        return EXIT_FAILURE;
     }
+
+    // The Core tree lives in its own arena; evaluation builds its
+    // substituted trees in a scratch arena that is rolled back after
+    // every step.
+    Arena *ast_arena = arena_create(ARENA_DEFAULT_CHUNK_SIZE);
+    Arena *scratch_arena = arena_create(ARENA_DEFAULT_CHUNK_SIZE);
+    core_arena_swap(ast_arena);
     
-    // Parse as Core expression instead of ML statements
-    CoreExpr *core_expr = parse_core_expression(&parser);
+    // Hash-consing applies to the program tree only; the evaluator's
+    // scratch trees are rolled back and must not be shared
+    CoreShareTable *share_table = share ? core_share_create() : NULL;
+    core_share_swap(share_table);
 
-    // Allow leftover tokens (type definitions might leave some)
-    // Don't require EOF for programs with type definitions
+    // A compiled cache is used in place from the mapping; a program is
+    // parsed into a pointer tree and flattened only when needed
+    int status = EXIT_SUCCESS;
+    CoreFlat flat;
+    core_flat_init(&flat);
+    CoreRef root = CORE_REF_NONE;
+    CoreExpr *core_expr = NULL;
+    int from_cache = source.text && core_cache_detect(source.text, source.length);
+    if (from_cache) {
+        if (!core_cache_load(&flat, &root, source.text, source.length)) {
+            status = EXIT_FAILURE;
+            goto cleanup;
+        }
+    } else {
+        // Flattening for --ast and --compile needs every body anyway
+        core_expr = parse_program(&source, jobs, lazy && !compile && !print_ast);
+        if (compile || print_ast) {
+            root = core_flat_from_expr(&flat, core_expr);
+        }
+    }
+    // The evaluator works on pointer trees, so a cache is rebuilt into
+    // one first, in time linear in its size
+    if (from_cache && !compile && !print_ast) {
+        core_expr = core_flat_to_expr(&flat, root);
+    }
+    core_share_swap(NULL);
 
-    if (print_ast) {
-        // Print AST instead of evaluating
-        core_expr_print(core_expr, 0);
+    if (compile) {
+        char *derived = output ? NULL : cache_filename(filename);
+        if (!core_cache_write(&flat, root, output ? output : derived)) {
+            status = EXIT_FAILURE;
+        }
+        free(derived);
+    } else if (print_ast) {
+        // Print AST instead of evaluating, from the compact flat encoding
+        core_flat_print(&flat, root, 0);
     } else {
         // Evaluate the Core expression (simple evaluator for now)
-        double result = core_eval_simple(core_expr);
+        core_arena_swap(scratch_arena);
+        CoreValue result = core_eval_value(core_expr);
 
-        // Output the result (same format as original)
-        printf("%f\n", result);
+        // Output the result (same format as original). Integers are
+        // printed from their exact value rather than rounded through a double.
+        core_value_print(result);
+        printf("\n");
+        core_value_free(result);
     }
 
+cleanup:
     // Clean up
-    free(program_text);
-    core_expr_free(core_expr);
+    core_share_swap(NULL);
+    if (!from_cache) {
+        core_flat_free(&flat);
+    }
+    source_close(&source);
+    core_share_free(share_table);
+    core_arena_swap(NULL);
+    arena_free(scratch_arena);
+    arena_free(ast_arena);
 
-    return EXIT_SUCCESS;
+    return status;
 }
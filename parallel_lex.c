@@ -0,0 +1,276 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "parallel_lex.h"
+#include "scan.h"
+
+// Pieces per thread; extra pieces keep threads busy when pieces lex at
+// different speeds (e.g. comment-heavy regions are much faster)
+#define PIECES_PER_THREAD 4
+// Pieces below this size are not worth a separate lexer
+#define MIN_PIECE_LENGTH (1024 * 1024)
+
+typedef struct
+{
+    size_t start; // First byte of the piece
+    size_t end;   // One past the last byte; the piece ends after a newline
+    TokenBuffer *tokens;
+    Interner *interner; // Names first seen in this piece
+} Piece;
+
+typedef struct
+{
+    const char *text;
+    Piece *pieces;
+    size_t piece_count;
+    atomic_size_t next_piece; // Next piece a worker should take
+} LexJob;
+
+static void *parallel_lex_alloc(size_t size)
+{
+    void *memory = malloc(size);
+    if (!memory)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for parallel lexer\n");
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+int parallel_lex_default_threads(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 1 ? (int)count : 1;
+}
+
+// ============================================================================
+// Boundary pre-scan
+// ============================================================================
+
+// Skip a {- -} comment whose '{' is at text[i], exactly as
+// lexer_skip_multi_line_comment does. Returns the index just past it.
+static size_t prescan_skip_comment(const char *text, size_t length, size_t i)
+{
+    const char *end = text + length;
+    const char *p = text + i + 2;
+    int nesting_level = 1;
+    while (nesting_level > 0)
+    {
+        p = scan_find_either(p, end, '{', '-');
+        if (p + 1 >= end)
+        {
+            return length; // Unterminated comment runs to the end of input
+        }
+        if (p[0] == '{' && p[1] == '-')
+        {
+            nesting_level++;
+            p += 2;
+        }
+        else if (p[0] == '-' && p[1] == '}')
+        {
+            nesting_level--;
+            p += 2;
+        }
+        else
+        {
+            p++;
+        }
+    }
+    return p - text;
+}
+
+// Fill bounds[1..] with safe boundaries, the first at or after each
+// multiple of `piece_length`. Returns the number of pieces, with
+// bounds[0] = 0 and bounds[count] = length.
+static size_t prescan_boundaries(const char *text, size_t length, size_t piece_length, size_t *bounds, size_t max_pieces)
+{
+    size_t count = 0;
+    bounds[0] = 0;
+    size_t target = piece_length;
+    size_t i = 0;
+
+    // Only '"', '{', '-' and '\n' can change or reveal the lexer's state
+    // between tokens: no other token contains them. Everything else is
+    // skipped byte by byte without classification.
+    while (i < length && count + 1 < max_pieces)
+    {
+        switch (text[i])
+        {
+        case '"':
+        {
+            const char *quote = scan_find_byte(text + i + 1, text + length, '"');
+            i = quote - text + 1; // An unterminated string ends the scan
+            break;
+        }
+        case '-':
+            if (i + 1 < length && text[i + 1] == '-')
+            {
+                // The newline ending the comment is itself a safe boundary
+                i = scan_find_byte(text + i + 2, text + length, '\n') - text;
+            }
+            else
+            {
+                i++;
+            }
+            break;
+        case '{':
+            if (i + 1 < length && text[i + 1] == '-')
+            {
+                i = prescan_skip_comment(text, length, i);
+            }
+            else
+            {
+                i++;
+            }
+            break;
+        case '\n':
+            i++;
+            if (i >= target && i < length)
+            {
+                bounds[++count] = i;
+                target = i + piece_length;
+            }
+            break;
+        default:
+            i++;
+            break;
+        }
+    }
+
+    bounds[++count] = length;
+    return count;
+}
+
+// ============================================================================
+// Workers and merge
+// ============================================================================
+
+static void *parallel_lex_worker(void *argument)
+{
+    LexJob *job = argument;
+    for (;;)
+    {
+        size_t index = atomic_fetch_add(&job->next_piece, 1);
+        if (index >= job->piece_count)
+        {
+            return NULL;
+        }
+        Piece *piece = &job->pieces[index];
+
+        // The lexer sees only this piece, but offsets stay relative to the
+        // whole text. Each piece interns into its own table, since the
+        // global interner is not thread-safe.
+        Lexer lexer = lexer_create_with_length(job->text, piece->end);
+        lexer_seek(&lexer, piece->start);
+        lexer.interner = piece->interner;
+        piece->tokens = token_buffer_create(job->text, piece->end);
+        Token token;
+        do
+        {
+            token = lexer_get_next_token(&lexer);
+            token_buffer_push(piece->tokens, token);
+        } while (token.type != TOKEN_EOF);
+    }
+}
+
+TokenBuffer *lexer_tokenize_parallel(const char *text, size_t length, int thread_count)
+{
+    if (thread_count < 2 || length < PARALLEL_LEX_MIN_LENGTH)
+    {
+        Lexer lexer = lexer_create_with_length(text, length);
+        return lexer_tokenize(&lexer);
+    }
+    if (length > UINT32_MAX)
+    {
+        fprintf(stderr, "Error: Source text too large to tokenize (%zu bytes)\n", length);
+        exit(EXIT_FAILURE);
+    }
+
+    size_t max_pieces = (size_t)thread_count * PIECES_PER_THREAD;
+    size_t piece_length = length / max_pieces;
+    if (piece_length < MIN_PIECE_LENGTH)
+    {
+        piece_length = MIN_PIECE_LENGTH;
+    }
+    size_t *bounds = parallel_lex_alloc((max_pieces + 1) * sizeof(size_t));
+    size_t piece_count = prescan_boundaries(text, length, piece_length, bounds, max_pieces);
+
+    LexJob job;
+    job.text = text;
+    job.piece_count = piece_count;
+    job.pieces = parallel_lex_alloc(piece_count * sizeof(Piece));
+    atomic_init(&job.next_piece, 0);
+    for (size_t i = 0; i < piece_count; i++)
+    {
+        job.pieces[i].start = bounds[i];
+        job.pieces[i].end = bounds[i + 1];
+        job.pieces[i].tokens = NULL;
+        job.pieces[i].interner = interner_create();
+    }
+    free(bounds);
+
+    // The calling thread works too
+    int worker_count = thread_count - 1;
+    pthread_t *workers = parallel_lex_alloc(worker_count * sizeof(pthread_t));
+    int started = 0;
+    while (started < worker_count && pthread_create(&workers[started], NULL, parallel_lex_worker, &job) == 0)
+    {
+        started++;
+    }
+    parallel_lex_worker(&job);
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    // Merge in source order, dropping every TOKEN_EOF but the last
+    size_t total = 1;
+    for (size_t i = 0; i < piece_count; i++)
+    {
+        total += job.pieces[i].tokens->count - 1;
+    }
+    TokenBuffer *merged = token_buffer_create(text, length);
+    token_buffer_reserve(merged, total);
+
+    Interner *global = interner_global();
+    for (size_t i = 0; i < piece_count; i++)
+    {
+        Piece *piece = &job.pieces[i];
+        TokenBuffer *tokens = piece->tokens;
+        size_t count = i + 1 < piece_count ? tokens->count - 1 : tokens->count;
+
+        // Interning each piece's names in the order the piece first saw
+        // them, piece by piece, hands out global Symbols in order of first
+        // appearance in the whole text, just like the serial lexer
+        Interner *local = piece->interner;
+        Symbol *remap = parallel_lex_alloc(local->count * sizeof(Symbol));
+        for (Symbol symbol = 0; symbol < local->count; symbol++)
+        {
+            remap[symbol] = interner_intern(global, local->names[symbol], local->lengths[symbol]);
+        }
+
+        size_t base = merged->count;
+        memcpy(merged->types + base, tokens->types, count * sizeof(uint8_t));
+        memcpy(merged->offsets + base, tokens->offsets, count * sizeof(uint32_t));
+        memcpy(merged->lengths + base, tokens->lengths, count * sizeof(uint32_t));
+        memcpy(merged->values + base, tokens->values, count * sizeof(TokenValue));
+        for (size_t t = base; t < base + count; t++)
+        {
+            if (merged->types[t] == TOKEN_IDENTIFIER)
+            {
+                merged->values[t].symbol = remap[merged->values[t].symbol];
+            }
+        }
+        merged->count += count;
+
+        free(remap);
+        token_buffer_free(tokens);
+        interner_free(local);
+    }
+    free(job.pieces);
+    return merged;
+}
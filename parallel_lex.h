@@ -0,0 +1,30 @@
+#ifndef PARALLEL_LEX_H
+#define PARALLEL_LEX_H
+
+#include <stddef.h>
+#include "token_buffer.h"
+
+// Parallel lexing
+// ===============
+// Splits text[0..length) into pieces at newlines where the lexer is
+// between tokens, lexes the pieces on `thread_count` worker threads, and
+// merges them into one TokenBuffer. The result, including the Symbol of
+// every identifier in the global interner, is identical to lexer_tokenize
+// on the whole text.
+//
+// A newline is a safe boundary when it is outside any string literal and
+// any (nested) {- -} comment. A newline that ends a -- comment is safe.
+// A serial pre-scan that only tracks those three states finds the
+// boundaries much faster than lexing would.
+//
+// Inputs smaller than PARALLEL_LEX_MIN_LENGTH, or a thread_count below 2,
+// are lexed serially.
+
+#define PARALLEL_LEX_MIN_LENGTH (8 * 1024 * 1024)
+
+TokenBuffer *lexer_tokenize_parallel(const char *text, size_t length, int thread_count);
+
+// Number of online processors, at least 1
+int parallel_lex_default_threads(void);
+
+#endif // PARALLEL_LEX_H
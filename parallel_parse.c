@@ -0,0 +1,321 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parallel_parse.h"
+#include "core.h"
+
+// Groups per thread, so threads stay busy when values differ in size
+#define GROUPS_PER_THREAD 4
+// Groups below this many tokens are not worth handing to a thread
+#define MIN_GROUP_TOKENS (16 * 1024)
+
+typedef struct
+{
+    Symbol name;
+    size_t value;     // Index of the value's first token
+    size_t in;        // Index of the 'in' that ends the value
+    CoreExpr *expr;   // Parsed value
+    int is_recursive; // The value mentions the name
+} Binding;
+
+typedef struct
+{
+    size_t first; // First binding of the group
+    size_t count;
+} Group;
+
+typedef struct
+{
+    TokenBuffer *tokens;
+    int lazy_lambdas;
+    int share;
+    Binding *bindings;
+    Group *groups;
+    size_t group_count;
+    atomic_size_t next_group; // Next group a worker should take
+    atomic_int failed;        // A value did not parse as the pre-scan expected
+} ParseJob;
+
+typedef struct
+{
+    ParseJob *job;
+    Arena *arena; // Where this worker's values are built
+} ParseWorker;
+
+static void *parallel_parse_alloc(void *memory, size_t size)
+{
+    memory = realloc(memory, size);
+    if (!memory)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for parallel parser\n");
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+// ============================================================================
+// Binding pre-scan
+// ============================================================================
+
+// Register the constructor of the pattern at token `index`, as parsing
+// the alternative would
+static void prescan_pattern(const TokenBuffer *tokens, size_t index)
+{
+    // "_" is the default pattern, not a constructor
+    if (tokens->lengths[index] == 1 && tokens->source[tokens->offsets[index]] == '_')
+    {
+        return;
+    }
+    core_constructor_id(tokens->values[index].symbol);
+}
+
+// Find the top-level bindings from token `start` on. A value ends at the
+// first 'in' not taken by a let inside it. Returns the number of
+// bindings, and in *body the index of the first token after them.
+static size_t prescan_bindings(const TokenBuffer *tokens, size_t start, Binding **bindings, size_t *body)
+{
+    const uint8_t *types = tokens->types;
+    size_t count = 0, capacity = 0;
+    size_t i = start;
+    while (types[i] == TOKEN_KEYWORD_LET && types[i + 1] == TOKEN_IDENTIFIER && types[i + 2] == TOKEN_EQUAL)
+    {
+        size_t j = i + 3;
+        int depth = 0;
+        for (;; j++)
+        {
+            TokenType type = types[j];
+            if (type == TOKEN_EOF)
+            {
+                // Not a complete binding; leave it to the body
+                *body = i;
+                return count;
+            }
+            if (type == TOKEN_KEYWORD_LET)
+            {
+                depth++;
+            }
+            else if (type == TOKEN_KEYWORD_IN)
+            {
+                if (depth == 0)
+                {
+                    break;
+                }
+                depth--;
+            }
+            else if ((type == TOKEN_KEYWORD_OF || type == TOKEN_PIPE || type == TOKEN_SEMICOLON) &&
+                     types[j + 1] == TOKEN_IDENTIFIER)
+            {
+                prescan_pattern(tokens, j + 1);
+            }
+        }
+
+        if (count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 1024;
+            *bindings = parallel_parse_alloc(*bindings, capacity * sizeof(Binding));
+        }
+        Binding *binding = &(*bindings)[count++];
+        binding->name = tokens->values[i + 1].symbol;
+        binding->value = i + 3;
+        binding->in = j;
+        binding->expr = NULL;
+        binding->is_recursive = 0;
+        i = j + 1;
+    }
+    *body = i;
+    return count;
+}
+
+// Split the bindings into groups of consecutive bindings of about
+// `group_tokens` tokens each
+static size_t group_bindings(const Binding *bindings, size_t binding_count, size_t group_tokens, Group **groups)
+{
+    size_t count = 0, capacity = 0;
+    size_t first = 0, group_size = 0;
+    for (size_t i = 0; i < binding_count; i++)
+    {
+        group_size += bindings[i].in - bindings[i].value + 1;
+        if (group_size >= group_tokens || i + 1 == binding_count)
+        {
+            if (count == capacity)
+            {
+                capacity = capacity ? capacity * 2 : 64;
+                *groups = parallel_parse_alloc(*groups, capacity * sizeof(Group));
+            }
+            (*groups)[count++] = (Group){first, i + 1 - first};
+            first = i + 1;
+            group_size = 0;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// Workers
+// ============================================================================
+
+// Returns 0 if a value ends before its 'in'
+static int parse_group(ParseJob *job, const Group *group)
+{
+    for (size_t i = group->first; i < group->first + group->count; i++)
+    {
+        Binding *binding = &job->bindings[i];
+        Parser parser = parser_create_from_tokens(job->tokens);
+        parser.lazy_lambdas = job->lazy_lambdas;
+        parser.token_index = binding->value;
+        parser.current_token = token_buffer_get(job->tokens, binding->value);
+
+        binding->expr = parse_core_expression(&parser);
+        if (parser.token_index != binding->in)
+        {
+            return 0;
+        }
+        // As parse_core_expression decides it for a let. Lazy bodies are
+        // scanned in the token buffer, as lexing them again would intern
+        // through the global interner, which is not locked.
+        binding->is_recursive = core_expr_contains_var_tokens(binding->expr, binding->name, job->tokens);
+    }
+    return 1;
+}
+
+static void *parallel_parse_worker(void *argument)
+{
+    ParseWorker *worker = argument;
+    ParseJob *job = worker->job;
+
+    // Core nodes go to this worker's arena, and are shared only with
+    // others built on this thread
+    Arena *previous_arena = core_arena_swap(worker->arena);
+    CoreShareTable *table = job->share ? core_share_create() : NULL;
+    CoreShareTable *previous_table = core_share_swap(table);
+    jmp_buf trap;
+    jmp_buf *previous_trap = parser_trap_errors(&trap);
+
+    for (;;)
+    {
+        size_t index = atomic_fetch_add(&job->next_group, 1);
+        if (index >= job->group_count || atomic_load(&job->failed))
+        {
+            break;
+        }
+        // parser_error lands here
+        if (setjmp(trap) != 0)
+        {
+            atomic_store(&job->failed, 1);
+            break;
+        }
+        if (!parse_group(job, &job->groups[index]))
+        {
+            atomic_store(&job->failed, 1);
+            break;
+        }
+    }
+
+    parser_trap_errors(previous_trap);
+    core_share_swap(previous_table);
+    core_share_free(table);
+    core_arena_swap(previous_arena);
+    return NULL;
+}
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+CoreExpr *parse_core_expression_parallel(Parser *parser, int thread_count)
+{
+    TokenBuffer *tokens = parser->tokens;
+    if (!tokens || thread_count < 2 || tokens->count - parser->token_index < PARALLEL_PARSE_MIN_TOKENS)
+    {
+        return parse_core_expression(parser);
+    }
+
+    // Workers must find every constructor already registered
+    core_constructor_count();
+    Binding *bindings = NULL;
+    size_t body;
+    size_t binding_count = prescan_bindings(tokens, parser->token_index, &bindings, &body);
+
+    size_t group_tokens = (body - parser->token_index) / ((size_t)thread_count * GROUPS_PER_THREAD);
+    if (group_tokens < MIN_GROUP_TOKENS)
+    {
+        group_tokens = MIN_GROUP_TOKENS;
+    }
+    Group *groups = NULL;
+    size_t group_count = group_bindings(bindings, binding_count, group_tokens, &groups);
+    if (group_count < 2)
+    {
+        free(bindings);
+        free(groups);
+        return parse_core_expression(parser);
+    }
+
+    ParseJob job;
+    job.tokens = tokens;
+    job.lazy_lambdas = parser->lazy_lambdas;
+    CoreShareTable *table = core_share_swap(NULL);
+    core_share_swap(table);
+    job.share = table != NULL;
+    job.bindings = bindings;
+    job.groups = groups;
+    job.group_count = group_count;
+    atomic_init(&job.next_group, 0);
+    atomic_init(&job.failed, 0);
+
+    ParseWorker *workers = parallel_parse_alloc(NULL, thread_count * sizeof(ParseWorker));
+    for (int i = 0; i < thread_count; i++)
+    {
+        workers[i].job = &job;
+        workers[i].arena = arena_create(ARENA_DEFAULT_CHUNK_SIZE);
+    }
+
+    // The calling thread works too
+    pthread_t *threads = parallel_parse_alloc(NULL, (thread_count - 1) * sizeof(pthread_t));
+    int started = 0;
+    while (started < thread_count - 1 &&
+           pthread_create(&threads[started], NULL, parallel_parse_worker, &workers[started + 1]) == 0)
+    {
+        started++;
+    }
+    parallel_parse_worker(&workers[0]);
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+
+    CoreExpr *result = NULL;
+    if (atomic_load(&job.failed))
+    {
+        // Parse serially to report the first error where it occurs
+        for (int i = 0; i < thread_count; i++)
+        {
+            arena_free(workers[i].arena);
+        }
+        result = parse_core_expression(parser);
+    }
+    else
+    {
+        // Parse the body and rebuild the let chain around it from the
+        // innermost binding out
+        parser->token_index = body;
+        parser->current_token = token_buffer_get(tokens, body);
+        result = parse_core_expression(parser);
+        for (size_t i = binding_count; i-- > 0;)
+        {
+            CoreVar *var = core_var_create_symbol(bindings[i].name, NULL, VAR_LOCAL);
+            result = core_let_var(var, bindings[i].expr, result, bindings[i].is_recursive);
+        }
+        for (int i = 0; i < thread_count; i++)
+        {
+            arena_attach(core_arena(), workers[i].arena);
+        }
+    }
+
+    free(workers);
+    free(bindings);
+    free(groups);
+    return result;
+}
@@ -0,0 +1,32 @@
+#ifndef PARALLEL_PARSE_H
+#define PARALLEL_PARSE_H
+
+#include "parser.h"
+
+// Parallel parsing
+// ================
+// A large program is usually a long chain of top-level bindings,
+//
+//     let f1 = v1 in let f2 = v2 in ... let fn = vn in body
+//
+// whose values can be parsed independently. A serial pre-scan of the
+// token buffer finds each value's extent by balancing `let` against `in`.
+// Groups of consecutive values are then parsed on `thread_count` worker
+// threads, each into its own arena, and the let chain is rebuilt around
+// the body in the current arena, which takes ownership of the worker
+// arenas. The result is the tree parse_core_expression would build.
+//
+// Workers only read shared state: the pre-scan declares the built-in
+// constructors and registers every constructor named in a pattern before
+// they start. If any value fails to parse or ends somewhere other than
+// the pre-scan found, the program is parsed again serially, so errors
+// are reported exactly as parse_core_expression reports them.
+//
+// A parser reading from a lexer, fewer than PARALLEL_PARSE_MIN_TOKENS
+// remaining tokens or a thread_count below 2 parse serially.
+
+#define PARALLEL_PARSE_MIN_TOKENS (256 * 1024)
+
+CoreExpr *parse_core_expression_parallel(Parser *parser, int thread_count);
+
+#endif // PARALLEL_PARSE_H
@@ -1,3 +1,4 @@
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -9,22 +10,153 @@ Parser parser_create(Lexer lexer)
 {
     Parser parser;
     parser.lexer = lexer;
+    parser.tokens = NULL;
+    parser.token_index = 0;
+    parser.lookahead_count = 0;
+    parser.lazy_lambdas = 0;
     parser.current_token = lexer_get_next_token(&parser.lexer);
     return parser;
 }
 
+Parser parser_create_from_tokens(TokenBuffer *tokens)
+{
+    Parser parser;
+    parser.lexer = lexer_create_with_length(tokens->source, 0);
+    parser.tokens = tokens;
+    parser.token_index = 0;
+    parser.lookahead_count = 0;
+    parser.lazy_lambdas = 0;
+    parser.current_token = token_buffer_get(tokens, 0);
+    return parser;
+}
+
+// Move to the next token regardless of the current token's type
+void parser_advance(Parser *parser)
+{
+    if (parser->tokens)
+    {
+        parser->current_token = token_buffer_get(parser->tokens, ++parser->token_index);
+    }
+    else if (parser->lookahead_count > 0)
+    {
+        parser->current_token = parser->lookahead[0];
+        parser->lookahead_count--;
+        memmove(parser->lookahead, parser->lookahead + 1, parser->lookahead_count * sizeof(Token));
+    }
+    else
+    {
+        parser->current_token = lexer_get_next_token(&parser->lexer);
+    }
+}
+
+// Return the token `ahead` positions after the current one (0 is the current token)
+Token parser_peek(Parser *parser, size_t ahead)
+{
+    if (parser->tokens)
+    {
+        return token_buffer_get(parser->tokens, parser->token_index + ahead);
+    }
+
+    // Without a token buffer, queue the tokens lexed ahead. The lexer may be
+    // reading a stream, so it cannot be copied and rewound.
+    if (ahead == 0)
+    {
+        return parser->current_token;
+    }
+    if (ahead > PARSER_MAX_LOOKAHEAD)
+    {
+        fprintf(stderr, "Error: Parser lookahead of %zu tokens exceeds the limit of %d\n", ahead, PARSER_MAX_LOOKAHEAD);
+        exit(EXIT_FAILURE);
+    }
+    while (parser->lookahead_count < ahead)
+    {
+        Token last = parser->lookahead_count > 0 ? parser->lookahead[parser->lookahead_count - 1] : parser->current_token;
+        parser->lookahead[parser->lookahead_count++] =
+            last.type == TOKEN_EOF ? last : lexer_get_next_token(&parser->lexer);
+    }
+    return parser->lookahead[ahead - 1];
+}
+
+SourcePosition parser_position(Parser *parser)
+{
+    size_t offset = parser->current_token.offset;
+    return parser->tokens ? token_buffer_position(parser->tokens, offset) : lexer_position(&parser->lexer, offset);
+}
+
+static _Thread_local jmp_buf *parser_error_trap = NULL;
+
+// A heap buffer owned by a parse in progress, which parser_error frees
+// when it longjmps past the parse. Holders form a stack per thread.
+typedef struct ParserBuffer
+{
+    void *memory; // Updated by the holder whenever it reallocates
+    struct ParserBuffer *next;
+} ParserBuffer;
+
+static _Thread_local ParserBuffer *parser_buffers = NULL;
+
+static void parser_buffer_hold(ParserBuffer *buffer, void *memory)
+{
+    buffer->memory = memory;
+    buffer->next = parser_buffers;
+    parser_buffers = buffer;
+}
+
+// `buffer` must be the most recently held
+static void parser_buffer_release(ParserBuffer *buffer)
+{
+    parser_buffers = buffer->next;
+}
+
+jmp_buf *parser_trap_errors(jmp_buf *trap)
+{
+    jmp_buf *previous = parser_error_trap;
+    parser_error_trap = trap;
+    return previous;
+}
+
+_Noreturn void parser_error(Parser *parser, const char *format, ...)
+{
+    if (parser_error_trap)
+    {
+        // The abandoned parses never reach their own cleanup
+        while (parser_buffers)
+        {
+            free(parser_buffers->memory);
+            parser_buffers = parser_buffers->next;
+        }
+        longjmp(*parser_error_trap, 1);
+    }
+
+    fprintf(stderr, "Error: ");
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+
+    SourcePosition position = parser_position(parser);
+    if (position.line > 0)
+    {
+        fprintf(stderr, " at line %zu, column %zu\n", position.line, position.column);
+    }
+    else
+    {
+        fprintf(stderr, " at byte %zu\n", parser->current_token.offset);
+    }
+    exit(EXIT_FAILURE);
+}
+
 void parser_eat(Parser *parser, TokenType token_type)
 {
     if (parser->current_token.type == token_type)
     {
-        parser->current_token = lexer_get_next_token(&parser->lexer);
+        parser_advance(parser);
     }
     else
     {
         const char *expected = token_type_to_string(token_type);
         const char *got = token_type_to_string(parser->current_token.type);
-        fprintf(stderr, "Error: Expected token type '%s' but got '%s'\n", expected, got);
-        exit(EXIT_FAILURE);
+        parser_error(parser, "Expected token type '%s' but got '%s'", expected, got);
     }
 }
 
@@ -56,7 +188,7 @@ Type *parse_atomic_type(Parser *parser)
     }
     else if (parser->current_token.type == TOKEN_IDENTIFIER)
     {
-        type->name = strdup(parser->current_token.text);
+        type->name = token_text_copy(&parser->current_token);
         type->kind = TYPE_ADT;
         parser_eat(parser, TOKEN_IDENTIFIER);
 
@@ -89,8 +221,7 @@ Type *parse_atomic_type(Parser *parser)
     else
     {
         const char *got = token_type_to_string(parser->current_token.type);
-        fprintf(stderr, "Error: Unexpected token '%s' while parsing type\n", got);
-        exit(EXIT_FAILURE);
+        parser_error(parser, "Unexpected token '%s' while parsing type", got);
     }
 
     return type;
@@ -246,7 +377,7 @@ ASTNode *parse_string(Parser *parser)
 {
     ASTNode *node = malloc(sizeof(ASTNode));
     node->type = AST_STRING;
-    node->string_value = strdup(parser->current_token.text);
+    node->string_value = token_text_copy(&parser->current_token);
     parser_eat(parser, TOKEN_STRING);
     return node;
 }
@@ -255,13 +386,14 @@ ASTNode *parse_factor(Parser *parser)
 {
     Token token = parser->current_token;
 
-    if (token.type == TOKEN_NUMBER)
+    if (token.type == TOKEN_NUMBER || token.type == TOKEN_INTEGER)
     {
-        parser_eat(parser, TOKEN_NUMBER);
+        parser_eat(parser, token.type);
 
+        // The legacy AST keeps every number as a double
         ASTNode *node = malloc(sizeof(ASTNode));
         node->type = AST_NUMBER;
-        node->number = token.value;
+        node->number = token.type == TOKEN_INTEGER ? (double)token.integer : token.value;
         return node;
     }
     else if (token.type == TOKEN_STRING)
@@ -277,7 +409,7 @@ ASTNode *parse_factor(Parser *parser)
     }
     else if (token.type == TOKEN_IDENTIFIER)
     {
-        char *name = strdup(token.text);
+        char *name = token_text_copy(&token);
         parser_eat(parser, TOKEN_IDENTIFIER);
 
         if (parser->current_token.type == TOKEN_LPAREN)
@@ -297,8 +429,7 @@ ASTNode *parse_factor(Parser *parser)
     else
     {
         const char *got = token_type_to_string(token.type);
-        fprintf(stderr, "Error: Unexpected token '%s' in factor\n", got);
-        exit(EXIT_FAILURE);
+        parser_error(parser, "Unexpected token '%s' in factor", got);
     }
 }
 
@@ -502,10 +633,9 @@ ASTNode *parse_adt_definition(Parser *parser)
     // Parse the type name
     if (parser->current_token.type != TOKEN_IDENTIFIER)
     {
-        fprintf(stderr, "Error: Expected type name after 'type'\n");
-        exit(EXIT_FAILURE);
+        parser_error(parser, "Expected type name after 'type'");
     }
-    char *type_name = strdup(parser->current_token.text);
+    char *type_name = token_text_copy(&parser->current_token);
     parser_eat(parser, TOKEN_IDENTIFIER);
 
     // Expect '='
@@ -519,10 +649,9 @@ ASTNode *parse_adt_definition(Parser *parser)
         // Parse costructor name
         if (parser->current_token.type != TOKEN_IDENTIFIER)
         {
-            fprintf(stderr, "Error: Expected constructor name\n");
-            exit(EXIT_FAILURE);
+            parser_error(parser, "Expected constructor name");
         }
-        char *constructor_name = strdup(parser->current_token.text);
+        char *constructor_name = token_text_copy(&parser->current_token);
         parser_eat(parser, TOKEN_IDENTIFIER);
 
         // Parse constructor fields (if any)
@@ -580,7 +709,7 @@ ASTNode *parse_adt_constructor_call(Parser *parser)
 {
     // For this example, constructors are treated similarly to function calls
     // Parse constructor arguments if any
-    char *constructor_name = strdup(parser->current_token.text);
+    char *constructor_name = token_text_copy(&parser->current_token);
     parser_eat(parser, TOKEN_IDENTIFIER);
 
     ASTNode **arguments = NULL;
@@ -935,10 +1064,9 @@ ASTNode *parse_function_definition(Parser *parser)
     // Expect an identifier (function name)
     if (parser->current_token.type != TOKEN_IDENTIFIER)
     {
-        fprintf(stderr, "Error: Expected function name after 'fun'\n");
-        exit(EXIT_FAILURE);
+        parser_error(parser, "Expected function name after 'fun'");
     }
-    char *func_name = strdup(parser->current_token.text);
+    char *func_name = token_text_copy(&parser->current_token);
     parser_eat(parser, TOKEN_IDENTIFIER);
 
     // Parse parameters
@@ -952,7 +1080,7 @@ ASTNode *parse_function_definition(Parser *parser)
         parameters = malloc(sizeof(char *) * 10); // Support up to 10 parameters for simplicity
         while (parser->current_token.type == TOKEN_IDENTIFIER)
         {
-            parameters[param_count++] = strdup(parser->current_token.text);
+            parameters[param_count++] = token_text_copy(&parser->current_token);
             parser_eat(parser, TOKEN_IDENTIFIER);
             if (parser->current_token.type == TOKEN_COMMA)
             {
@@ -968,8 +1096,7 @@ ASTNode *parse_function_definition(Parser *parser)
     // Expect '='
     if (parser->current_token.type != TOKEN_EQUAL)
     {
-        fprintf(stderr, "Error: Expected '=' after function parameters\n");
-        exit(EXIT_FAILURE);
+        parser_error(parser, "Expected '=' after function parameters");
     }
     parser_eat(parser, TOKEN_EQUAL);
 
@@ -1032,10 +1159,9 @@ ASTNode *parse_let_binding(Parser *parser)
     // Expect an identifier
     if (parser->current_token.type != TOKEN_IDENTIFIER)
     {
-        fprintf(stderr, "Error: Expected variable name after 'let'\n");
-        exit(EXIT_FAILURE);
+        parser_error(parser, "Expected variable name after 'let'");
     }
-    char *var_name = strdup(parser->current_token.text);
+    char *var_name = token_text_copy(&parser->current_token);
     parser_eat(parser, TOKEN_IDENTIFIER);
 
     // Expect '='
@@ -1190,16 +1316,15 @@ ASTNode *parse_case_expression(Parser *parser)
         // Parse Constructor
         if (parser->current_token.type != TOKEN_IDENTIFIER)
         {
-            fprintf(stderr, "Error: Expected constructor in case pattern\n");
-            exit(EXIT_FAILURE);
+            parser_error(parser, "Expected constructor in case pattern");
         }
-        new_pattern->constructor = strdup(parser->current_token.text);
+        new_pattern->constructor = token_text_copy(&parser->current_token);
         parser_eat(parser, TOKEN_IDENTIFIER);
 
         // Parse Variable (Optional)
         if (parser->current_token.type == TOKEN_IDENTIFIER)
         {
-            new_pattern->variable = strdup(parser->current_token.text);
+            new_pattern->variable = token_text_copy(&parser->current_token);
             parser_eat(parser, TOKEN_IDENTIFIER);
         }
         else
@@ -1210,8 +1335,7 @@ ASTNode *parse_case_expression(Parser *parser)
         // Parse '=>'
         if (parser->current_token.type != TOKEN_FAT_ARROW)
         {
-            fprintf(stderr, "Error: Expected '=>' in case pattern\n");
-            exit(EXIT_FAILURE);
+            parser_error(parser, "Expected '=>' in case pattern");
         }
         parser_eat(parser, TOKEN_FAT_ARROW);
 
@@ -1236,29 +1360,90 @@ ASTNode *parse_case_expression(Parser *parser)
 // Core Expression Parsing (Phase 2)
 // ============================================================================
 
-// Parse Core expressions: handles let, lambda, case, application
-CoreExpr *parse_core_expression(Parser *parser) {
-    // Check for let expression
-    if (parser->current_token.type == TOKEN_KEYWORD_LET) {
-        return parse_core_let(parser);
-    }
-    
-    // Check for lambda expression: \x. body
-    if (parser->current_token.type == TOKEN_BACKSLASH) {
-        return parse_core_lambda(parser);
+// Parsing is driven by an explicit stack of pending constructs instead of
+// recursion, so nesting depth (e.g. long let-chains) is limited only by
+// memory. Each frame is a construct waiting for its next subexpression.
+typedef enum {
+    CORE_FRAME_APP,         // Function applied so far, awaiting an argument
+    CORE_FRAME_PAREN,       // ( [expr] )
+    CORE_FRAME_LET_VALUE,   // let var = [value] in body
+    CORE_FRAME_LET_BODY,    // let var = value in [body]
+    CORE_FRAME_LAM_BODY,    // \var. [body]
+    CORE_FRAME_CASE_EXPR,   // case [expr] of alts
+    CORE_FRAME_CASE_ALT     // case expr of ... pattern -> [result]
+} CoreFrameKind;
+
+typedef struct {
+    CoreFrameKind kind;
+    CoreVar *var;           // Let or lambda variable
+    CoreExpr *expr;         // Function so far, let value or case scrutinee
+    CoreAlt **alts;         // Case alternatives parsed so far
+    int alt_count;
+    int alt_capacity;
+    int is_default;         // Pattern of the alternative being parsed
+    Symbol constructor;
+    CoreVar **vars;
+    int var_count;
+} CoreFrame;
+
+typedef struct {
+    CoreFrame *frames;
+    size_t count;
+    size_t capacity;
+    ParserBuffer held;      // Holds frames for parser_error
+} CoreFrameStack;
+
+static CoreFrame *core_frame_push(CoreFrameStack *stack, CoreFrameKind kind) {
+    if (stack->count == stack->capacity) {
+        stack->capacity = stack->capacity ? stack->capacity * 2 : 64;
+        CoreFrame *frames = realloc(stack->frames, stack->capacity * sizeof(CoreFrame));
+        if (!frames) {
+            fprintf(stderr, "Error: Memory allocation failed for parser stack\n");
+            exit(EXIT_FAILURE);
+        }
+        stack->frames = frames;
+        stack->held.memory = frames;
     }
-    
-    // Check for case expression
-    if (parser->current_token.type == TOKEN_KEYWORD_CASE) {
-        return parse_core_case(parser);
+    CoreFrame *frame = &stack->frames[stack->count++];
+    memset(frame, 0, sizeof(CoreFrame));
+    frame->kind = kind;
+    return frame;
+}
+
+static int core_token_starts_atom(TokenType type) {
+    return type == TOKEN_NUMBER ||
+           type == TOKEN_INTEGER ||
+           type == TOKEN_STRING ||
+           type == TOKEN_IDENTIFIER ||
+           type == TOKEN_LPAREN;
+}
+
+// Well-known symbol of an operator that can be written in parentheses
+// like (+), or SYMBOL_NONE
+static Symbol core_operator_symbol(TokenType type) {
+    switch (type) {
+        case TOKEN_PLUS: return SYM_PLUS;
+        case TOKEN_MINUS: return SYM_MINUS;
+        case TOKEN_MUL: return SYM_MUL;
+        case TOKEN_DIV: return SYM_DIV;
+        case TOKEN_EQUAL_EQUAL: return SYM_EQUAL_EQUAL;
+        case TOKEN_NOT_EQUAL: return SYM_NOT_EQUAL;
+        case TOKEN_LESS: return SYM_LESS;
+        case TOKEN_LESS_EQUAL: return SYM_LESS_EQUAL;
+        case TOKEN_GREATER: return SYM_GREATER;
+        case TOKEN_GREATER_EQUAL: return SYM_GREATER_EQUAL;
+        default: return SYMBOL_NONE;
     }
-    
-    // Otherwise, parse application
-    return parse_core_application(parser);
 }
 
-// Parse atomic Core expressions: variables, literals, parenthesized expressions
-CoreExpr *parse_core_atom(Parser *parser) {
+// Parse a literal or variable
+static CoreExpr *parse_core_leaf(Parser *parser) {
+    if (parser->current_token.type == TOKEN_INTEGER) {
+        int64_t val = parser->current_token.integer;
+        parser_eat(parser, TOKEN_INTEGER);
+        return core_int(val);
+    }
+    
     if (parser->current_token.type == TOKEN_NUMBER) {
         double val = parser->current_token.value;
         parser_eat(parser, TOKEN_NUMBER);
@@ -1266,177 +1451,537 @@ CoreExpr *parse_core_atom(Parser *parser) {
     }
     
     if (parser->current_token.type == TOKEN_STRING) {
-        char *str = strdup(parser->current_token.text);
+        Token token = parser->current_token;
+        CoreExpr *str = core_expr_create_lit(core_lit_create_string_n(token.text, token.length));
         parser_eat(parser, TOKEN_STRING);
-        return core_string(str);
+        return str;
     }
     
     if (parser->current_token.type == TOKEN_IDENTIFIER) {
-        char *name = strdup(parser->current_token.text);
+        Token token = parser->current_token;
+        CoreExpr *var = core_var_symbol(token.symbol);
         parser_eat(parser, TOKEN_IDENTIFIER);
-        return core_var(name);
+        return var;
     }
     
-    // Handle parenthesized expressions
-    if (parser->current_token.type == TOKEN_LPAREN) {
-        parser_eat(parser, TOKEN_LPAREN);
-        
-        // Check if this is an operator in parentheses like (+), (-), (*), (/)
-        if (parser->current_token.type == TOKEN_PLUS ||
-            parser->current_token.type == TOKEN_MINUS ||
-            parser->current_token.type == TOKEN_MUL ||
-            parser->current_token.type == TOKEN_DIV ||
-            parser->current_token.type == TOKEN_EQUAL_EQUAL ||
-            parser->current_token.type == TOKEN_NOT_EQUAL ||
-            parser->current_token.type == TOKEN_LESS ||
-            parser->current_token.type == TOKEN_LESS_EQUAL ||
-            parser->current_token.type == TOKEN_GREATER ||
-            parser->current_token.type == TOKEN_GREATER_EQUAL) {
-            
-            // Convert operator token to variable name
-            char *op_name = NULL;
-            switch (parser->current_token.type) {
-                case TOKEN_PLUS: op_name = strdup("+"); break;
-                case TOKEN_MINUS: op_name = strdup("-"); break;
-                case TOKEN_MUL: op_name = strdup("*"); break;
-                case TOKEN_DIV: op_name = strdup("/"); break;
-                case TOKEN_EQUAL_EQUAL: op_name = strdup("=="); break;
-                case TOKEN_NOT_EQUAL: op_name = strdup("!="); break;
-                case TOKEN_LESS: op_name = strdup("<"); break;
-                case TOKEN_LESS_EQUAL: op_name = strdup("<="); break;
-                case TOKEN_GREATER: op_name = strdup(">"); break;
-                case TOKEN_GREATER_EQUAL: op_name = strdup(">="); break;
-                default: break;
+    parser_error(parser, "Unexpected token in Core expression: %s",
+                 token_type_to_string(parser->current_token.type));
+}
+
+// Parse a case alternative's pattern into the frame: "_ ->" or
+// "Constructor var1 var2 ... ->" with one variable per bound field
+static void parse_core_alt_pattern(Parser *parser, CoreFrame *frame) {
+    Token constructor = parser->current_token;
+    parser_eat(parser, TOKEN_IDENTIFIER);
+    frame->is_default = constructor.length == 1 && constructor.text[0] == '_';
+    frame->constructor = constructor.symbol;
+    frame->vars = NULL;
+    frame->var_count = 0;
+    
+    // Handle variable bindings in pattern (e.g., "Just n", "Pair a b")
+    int var_capacity = 0;
+    while (!frame->is_default && parser->current_token.type == TOKEN_IDENTIFIER) {
+        if (frame->var_count == var_capacity) {
+            var_capacity = var_capacity ? var_capacity * 2 : 4;
+            CoreVar **vars = (CoreVar **)core_alloc(var_capacity * sizeof(CoreVar *));
+            if (frame->var_count > 0) {
+                memcpy(vars, frame->vars, frame->var_count * sizeof(CoreVar *));
             }
-            
-            parser_eat(parser, parser->current_token.type);
-            parser_eat(parser, TOKEN_RPAREN);
-            return core_var(op_name);
-        } else {
-            // Regular parenthesized expression
-            CoreExpr *expr = parse_core_expression(parser);
-            parser_eat(parser, TOKEN_RPAREN);
-            return expr;
+            frame->vars = vars;
         }
+        Token bound = parser->current_token;
+        frame->vars[frame->var_count++] = core_var_create_symbol(bound.symbol, NULL, 0);
+        parser_eat(parser, TOKEN_IDENTIFIER);
     }
     
-    fprintf(stderr, "Error: Unexpected token in Core expression: %s\n", 
-            token_type_to_string(parser->current_token.type));
-    exit(EXIT_FAILURE);
+    parser_eat(parser, TOKEN_ARROW);
+}
+
+// Kinds of construct open while skipping a lambda body
+enum {
+    CORE_SKIP_PAREN,        // ( ... ), closed by ')'
+    CORE_SKIP_LET,          // let ... = ..., closed by 'in'
+    CORE_SKIP_CASE          // case ..., closed by 'of'
+};
+
+// Parse the pattern of a case alternative without building it
+static int core_skip_alt_pattern(Parser *parser) {
+    while (parser->current_token.type == TOKEN_IDENTIFIER) {
+        parser_advance(parser);
+    }
+    if (parser->current_token.type != TOKEN_ARROW) return 0;
+    parser_advance(parser);
+    return 1;
 }
 
-// Parse Core application: f x y (left-associative)
-CoreExpr *parse_core_application(Parser *parser) {
-    CoreExpr *expr = parse_core_atom(parser);
+// Move past a lambda body the way parse_core_expression would parse it,
+// without building anything. Inside parentheses, a let value or a case
+// scrutinee only the brackets and keywords that close them are tracked;
+// at the outermost level the body ends at the first token that cannot
+// continue it. Returns 0, with the parser somewhere in the body, if it
+// is malformed.
+static int core_skip_lambda_body(Parser *parser) {
+    unsigned char open_local[64];
+    unsigned char *open = open_local;
+    size_t depth = 0, capacity = sizeof(open_local);
+    ParserBuffer held;      // Holds open once it moves to the heap
+    // At the outermost level: expecting an expression, in an application
+    // that further atoms extend, or after a complete expression
+    enum { SKIP_EXPRESSION, SKIP_APPLICATION, SKIP_COMPLETE } state = SKIP_EXPRESSION;
+    int open_cases = 0;     // Outermost cases still taking alternatives
+    int ok = 1;
     
-    // Keep applying as long as we have atoms
-    while (parser->current_token.type == TOKEN_NUMBER ||
-           parser->current_token.type == TOKEN_STRING ||
-           parser->current_token.type == TOKEN_IDENTIFIER ||
-           parser->current_token.type == TOKEN_LPAREN) {
-        CoreExpr *arg = parse_core_atom(parser);
-        expr = core_expr_create_app(expr, arg);
+    for (;;) {
+        TokenType type = parser->current_token.type;
+        int opened = -1;
+        if (depth > 0 || state == SKIP_EXPRESSION || (state == SKIP_APPLICATION && type == TOKEN_LPAREN)) {
+            if (type == TOKEN_LPAREN) {
+                opened = CORE_SKIP_PAREN;
+            } else if (type == TOKEN_KEYWORD_LET && (depth > 0 || state == SKIP_EXPRESSION)) {
+                opened = CORE_SKIP_LET;
+            } else if (type == TOKEN_KEYWORD_CASE && (depth > 0 || state == SKIP_EXPRESSION)) {
+                opened = CORE_SKIP_CASE;
+            }
+        }
+        if (opened >= 0) {
+            if (depth == capacity) {
+                capacity *= 2;
+                unsigned char *grown = malloc(capacity);
+                if (!grown) {
+                    fprintf(stderr, "Error: Memory allocation failed for parser stack\n");
+                    exit(EXIT_FAILURE);
+                }
+                memcpy(grown, open, depth);
+                if (open != open_local) {
+                    free(open);
+                    held.memory = grown;
+                } else {
+                    parser_buffer_hold(&held, grown);
+                }
+                open = grown;
+            }
+            open[depth++] = (unsigned char)opened;
+            parser_advance(parser);
+            continue;
+        }
+        
+        if (depth > 0) {
+            int closed = type == TOKEN_RPAREN ? CORE_SKIP_PAREN :
+                         type == TOKEN_KEYWORD_IN ? CORE_SKIP_LET :
+                         type == TOKEN_KEYWORD_OF ? CORE_SKIP_CASE : -1;
+            if (type == TOKEN_EOF || (closed >= 0 && open[depth - 1] != closed)) {
+                ok = 0;
+                break;
+            }
+            parser_advance(parser);
+            if (closed < 0 || --depth > 0) continue;
+            
+            // Back at the outermost level
+            if (closed == CORE_SKIP_PAREN) {
+                state = SKIP_APPLICATION;
+            } else if (closed == CORE_SKIP_LET) {
+                state = SKIP_EXPRESSION;
+            } else if (parser->current_token.type == TOKEN_IDENTIFIER) {
+                open_cases++;
+                if (!core_skip_alt_pattern(parser)) {
+                    ok = 0;
+                    break;
+                }
+                state = SKIP_EXPRESSION;
+            } else {
+                state = SKIP_COMPLETE;
+            }
+            continue;
+        }
+        
+        if (state == SKIP_EXPRESSION) {
+            if (type == TOKEN_BACKSLASH) {
+                // A nested lambda's body extends as far as this one's
+                parser_advance(parser);
+                if (parser->current_token.type != TOKEN_IDENTIFIER) {
+                    ok = 0;
+                    break;
+                }
+                parser_advance(parser);
+                if (parser->current_token.type != TOKEN_DOT) {
+                    ok = 0;
+                    break;
+                }
+                parser_advance(parser);
+            } else if (core_token_starts_atom(type)) {
+                parser_advance(parser);
+                state = SKIP_APPLICATION;
+            } else {
+                ok = 0;
+                break;
+            }
+            continue;
+        }
+        
+        if (state == SKIP_APPLICATION && core_token_starts_atom(type)) {
+            parser_advance(parser);
+            continue;
+        }
+        
+        // A separator starts the next alternative of the innermost case,
+        // or ends that case if no pattern follows
+        if ((type == TOKEN_PIPE || type == TOKEN_SEMICOLON) && open_cases > 0) {
+            parser_advance(parser);
+            if (parser->current_token.type == TOKEN_IDENTIFIER) {
+                if (!core_skip_alt_pattern(parser)) {
+                    ok = 0;
+                    break;
+                }
+                state = SKIP_EXPRESSION;
+                continue;
+            }
+            state = SKIP_COMPLETE;
+            if (--open_cases > 0) continue;
+        }
+        break;
     }
     
-    return expr;
+    if (open != open_local) {
+        parser_buffer_release(&held);
+        free(open);
+    }
+    return ok;
 }
 
-// Parse Core lambda: \x. body
-CoreExpr *parse_core_lambda(Parser *parser) {
-    parser_eat(parser, TOKEN_BACKSLASH);
+// Parse Core expressions: let, lambda, case and application (f x y,
+// left-associative) of literals, variables, (op) and parenthesized
+// expressions
+CoreExpr *parse_core_expression(Parser *parser) {
+    CoreFrameStack stack = {NULL, 0, 0, {NULL, NULL}};
+    parser_buffer_hold(&stack.held, NULL);
+    CoreExpr *result = NULL;
+    enum { START_EXPRESSION, START_ATOM, REDUCE } state = START_EXPRESSION;
     
-    if (parser->current_token.type != TOKEN_IDENTIFIER) {
-        fprintf(stderr, "Error: Expected parameter name in lambda\n");
-        exit(EXIT_FAILURE);
+    for (;;) {
+        if (state == START_EXPRESSION) {
+            if (parser->current_token.type == TOKEN_KEYWORD_LET) {
+                // let x = value in body
+                parser_eat(parser, TOKEN_KEYWORD_LET);
+                if (parser->current_token.type != TOKEN_IDENTIFIER) {
+                    parser_error(parser, "Expected variable name in let");
+                }
+                Token name = parser->current_token;
+                CoreFrame *frame = core_frame_push(&stack, CORE_FRAME_LET_VALUE);
+                frame->var = core_var_create_symbol(name.symbol, NULL, VAR_LOCAL);
+                parser_eat(parser, TOKEN_IDENTIFIER);
+                parser_eat(parser, TOKEN_EQUAL);
+            } else if (parser->current_token.type == TOKEN_BACKSLASH) {
+                // \x. body
+                parser_eat(parser, TOKEN_BACKSLASH);
+                if (parser->current_token.type != TOKEN_IDENTIFIER) {
+                    parser_error(parser, "Expected parameter name in lambda");
+                }
+                Token param = parser->current_token;
+                CoreVar *var = core_var_create_symbol(param.symbol, NULL, VAR_LOCAL);
+                parser_eat(parser, TOKEN_IDENTIFIER);
+                parser_eat(parser, TOKEN_DOT);
+                
+                if (parser->lazy_lambdas) {
+                    // Only find where the body ends. A malformed body is
+                    // parsed now instead, to report the error.
+                    Parser body_start = *parser;
+                    if (core_skip_lambda_body(parser)) {
+                        CoreLazyBody *lazy = core_alloc(sizeof(CoreLazyBody));
+                        lazy->text = parser->tokens ? parser->tokens->source : parser->lexer.text;
+                        lazy->length = parser->tokens ? parser->tokens->source_length : parser->lexer.length;
+                        lazy->offset = body_start.current_token.offset;
+                        lazy->end = parser->current_token.offset;
+                        lazy->arena = core_arena();
+                        lazy->body = NULL;
+                        result = core_expr_create_lazy_lam(var, lazy);
+                        state = REDUCE;
+                        continue;
+                    }
+                    *parser = body_start;
+                }
+                CoreFrame *frame = core_frame_push(&stack, CORE_FRAME_LAM_BODY);
+                frame->var = var;
+            } else if (parser->current_token.type == TOKEN_KEYWORD_CASE) {
+                // case expr of pattern -> result; pattern -> result
+                parser_eat(parser, TOKEN_KEYWORD_CASE);
+                core_frame_push(&stack, CORE_FRAME_CASE_EXPR);
+            } else {
+                core_frame_push(&stack, CORE_FRAME_APP);
+                state = START_ATOM;
+            }
+            continue;
+        }
+        
+        if (state == START_ATOM) {
+            if (parser->current_token.type != TOKEN_LPAREN) {
+                result = parse_core_leaf(parser);
+                state = REDUCE;
+                continue;
+            }
+            parser_eat(parser, TOKEN_LPAREN);
+            
+            // An operator in parentheses like (+), (-), (*), (/)
+            Symbol op_name = core_operator_symbol(parser->current_token.type);
+            if (op_name != SYMBOL_NONE) {
+                parser_eat(parser, parser->current_token.type);
+                parser_eat(parser, TOKEN_RPAREN);
+                result = core_var_symbol(op_name);
+                state = REDUCE;
+            } else {
+                // Regular parenthesized expression
+                core_frame_push(&stack, CORE_FRAME_PAREN);
+                state = START_EXPRESSION;
+            }
+            continue;
+        }
+        
+        // REDUCE: hand the finished `result` to the innermost pending construct
+        if (stack.count == 0) {
+            parser_buffer_release(&stack.held);
+            free(stack.frames);
+            return result;
+        }
+        CoreFrame *frame = &stack.frames[stack.count - 1];
+        switch (frame->kind) {
+            case CORE_FRAME_APP:
+                frame->expr = frame->expr ? core_expr_create_app(frame->expr, result) : result;
+                // Keep applying as long as we have atoms
+                if (core_token_starts_atom(parser->current_token.type)) {
+                    state = START_ATOM;
+                    continue;
+                }
+                result = frame->expr;
+                stack.count--;
+                break;
+                
+            case CORE_FRAME_PAREN:
+                parser_eat(parser, TOKEN_RPAREN);
+                stack.count--;
+                break;
+                
+            case CORE_FRAME_LET_VALUE:
+                frame->expr = result;
+                frame->kind = CORE_FRAME_LET_BODY;
+                parser_eat(parser, TOKEN_KEYWORD_IN);
+                state = START_EXPRESSION;
+                continue;
+                
+            case CORE_FRAME_LET_BODY: {
+                // Check if this should be a recursive let by looking for the variable name in the value expression
+                int is_recursive = core_expr_contains_var_tokens(frame->expr, frame->var->name, parser->tokens);
+                result = core_let_var(frame->var, frame->expr, result, is_recursive);
+                stack.count--;
+                break;
+            }
+                
+            case CORE_FRAME_LAM_BODY:
+                result = core_expr_create_lam(frame->var, result);
+                stack.count--;
+                break;
+                
+            case CORE_FRAME_CASE_EXPR:
+                frame->expr = result;
+                parser_eat(parser, TOKEN_KEYWORD_OF);
+                
+                frame->alts = NULL;
+                frame->alt_count = 0;
+                frame->alt_capacity = 0;
+                if (parser->current_token.type == TOKEN_IDENTIFIER) {
+                    parse_core_alt_pattern(parser, frame);
+                    frame->kind = CORE_FRAME_CASE_ALT;
+                    state = START_EXPRESSION;
+                    continue;
+                }
+                result = core_expr_create_case(frame->expr, NULL, NULL, frame->alts, frame->alt_count);
+                stack.count--;
+                break;
+                
+            case CORE_FRAME_CASE_ALT:
+                if (frame->alt_count == frame->alt_capacity) {
+                    // Alternatives live in the arena, so grow by copying
+                    frame->alt_capacity = frame->alt_capacity ? frame->alt_capacity * 2 : 4;
+                    CoreAlt **alts = (CoreAlt **)core_alloc(frame->alt_capacity * sizeof(CoreAlt *));
+                    if (frame->alt_count > 0) {
+                        memcpy(alts, frame->alts, frame->alt_count * sizeof(CoreAlt *));
+                    }
+                    frame->alts = alts;
+                }
+                frame->alts[frame->alt_count++] = frame->is_default ? core_alt_create_default(result) :
+                    core_alt_create_con_symbol(frame->constructor, frame->vars, frame->var_count, result);
+                
+                // Alternatives are separated by a pipe or semicolon
+                if (parser->current_token.type == TOKEN_PIPE || parser->current_token.type == TOKEN_SEMICOLON) {
+                    parser_eat(parser, parser->current_token.type);
+                    if (parser->current_token.type == TOKEN_IDENTIFIER) {
+                        parse_core_alt_pattern(parser, frame);
+                        state = START_EXPRESSION;
+                        continue;
+                    }
+                }
+                result = core_expr_create_case(frame->expr, NULL, NULL, frame->alts, frame->alt_count);
+                stack.count--;
+                break;
+        }
     }
-    
-    char *param_name = strdup(parser->current_token.text);
-    parser_eat(parser, TOKEN_IDENTIFIER);
-    parser_eat(parser, TOKEN_DOT);
-    
-    CoreExpr *body = parse_core_expression(parser);
-    return core_lambda(param_name, body);
 }
 
-// Parse Core let: let x = value in body
-CoreExpr *parse_core_let(Parser *parser) {
-    parser_eat(parser, TOKEN_KEYWORD_LET);
-    
-    if (parser->current_token.type != TOKEN_IDENTIFIER) {
-        fprintf(stderr, "Error: Expected variable name in let\n");
-        exit(EXIT_FAILURE);
+// Type of a constructor field: Number, String, a type name or variable,
+// or the head of a parenthesized type such as (Maybe a)
+static Symbol parse_core_field_type(Parser *parser) {
+    if (parser->current_token.type == TOKEN_TYPE_NUMBER) {
+        parser_eat(parser, TOKEN_TYPE_NUMBER);
+        return symbol_intern_cstr("Number");
+    }
+    if (parser->current_token.type == TOKEN_TYPE_STRING) {
+        parser_eat(parser, TOKEN_TYPE_STRING);
+        return symbol_intern_cstr("String");
+    }
+    if (parser->current_token.type == TOKEN_IDENTIFIER) {
+        Symbol type = parser->current_token.symbol;
+        parser_eat(parser, TOKEN_IDENTIFIER);
+        return type;
     }
     
-    char *var_name = strdup(parser->current_token.text);
-    parser_eat(parser, TOKEN_IDENTIFIER);
-    parser_eat(parser, TOKEN_EQUAL);
-    
-    CoreExpr *value = parse_core_expression(parser);
-    
-    parser_eat(parser, TOKEN_KEYWORD_IN);
-    CoreExpr *body = parse_core_expression(parser);
-    
-    // Check if this should be a recursive let by looking for the variable name in the value expression
-    if (core_expr_contains_var(value, var_name)) {
-        return core_letrec_simple(var_name, value, body);
-    } else {
-        return core_let_simple(var_name, value, body);
+    parser_eat(parser, TOKEN_LPAREN);
+    Symbol type = parse_core_field_type(parser);
+    while (parser->current_token.type != TOKEN_RPAREN) {
+        if (parser->current_token.type == TOKEN_EOF) {
+            parser_error(parser, "Expected ')' in constructor field type");
+        }
+        parse_core_field_type(parser);
     }
+    parser_eat(parser, TOKEN_RPAREN);
+    return type;
 }
 
-// Parse Core case: case expr of pattern -> result; pattern -> result
-CoreExpr *parse_core_case(Parser *parser) {
-    parser_eat(parser, TOKEN_KEYWORD_CASE);
-    
-    CoreExpr *expr = parse_core_expression(parser);
-    parser_eat(parser, TOKEN_KEYWORD_OF);
+// Parse "type Name params = Con fields | Con fields ..." and declare each
+// constructor with its position as its tag. The declaration ends at the
+// first token that cannot be a field, and may be followed by ';'.
+void parse_core_type_declaration(Parser *parser) {
+    parser_eat(parser, TOKEN_TYPE);
+    if (parser->current_token.type != TOKEN_IDENTIFIER) {
+        parser_error(parser, "Expected type name after 'type'");
+    }
+    Symbol type = parser->current_token.symbol;
+    parser_eat(parser, TOKEN_IDENTIFIER);
     
-    // For now, implement a simple case parser
-    // In a full implementation, we'd handle multiple patterns
-    CoreAlt **alts = (CoreAlt **)malloc(2 * sizeof(CoreAlt *));
-    int alt_count = 0;
+    // Type parameters only name field types
+    while (parser->current_token.type == TOKEN_IDENTIFIER) {
+        parser_eat(parser, TOKEN_IDENTIFIER);
+    }
+    parser_eat(parser, TOKEN_EQUAL);
     
-    // Parse first alternative
-    if (parser->current_token.type == TOKEN_IDENTIFIER) {
-        char *constructor = strdup(parser->current_token.text);
+    Symbol *fields = NULL;
+    int field_capacity = 0;
+    for (int tag = 0;; tag++) {
+        if (parser->current_token.type != TOKEN_IDENTIFIER) {
+            parser_error(parser, "Expected constructor name");
+        }
+        Symbol name = parser->current_token.symbol;
         parser_eat(parser, TOKEN_IDENTIFIER);
         
-        // Handle variable binding in pattern (e.g., "Just n")
-        char *var_name = NULL;
-        if (parser->current_token.type == TOKEN_IDENTIFIER) {
-            var_name = strdup(parser->current_token.text);
-            parser_eat(parser, TOKEN_IDENTIFIER);
+        int arity = 0;
+        while (parser->current_token.type == TOKEN_TYPE_NUMBER ||
+               parser->current_token.type == TOKEN_TYPE_STRING ||
+               parser->current_token.type == TOKEN_IDENTIFIER ||
+               parser->current_token.type == TOKEN_LPAREN) {
+            if (arity == field_capacity) {
+                field_capacity = field_capacity ? field_capacity * 2 : 4;
+                fields = realloc(fields, field_capacity * sizeof(Symbol));
+                if (!fields) {
+                    fprintf(stderr, "Error: Memory allocation failed for constructor fields\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            fields[arity++] = parse_core_field_type(parser);
         }
+        core_constructor_declare(type, tag, name, fields, arity);
         
-        parser_eat(parser, TOKEN_ARROW);
-        CoreExpr *result = parse_core_expression(parser);
-        
-        // Create variable if we have binding
-        CoreVar **vars = NULL;
-        int var_count = 0;
-        if (var_name) {
-            vars = (CoreVar **)malloc(sizeof(CoreVar *));
-            vars[0] = core_var_create(var_name, NULL, 0);
-            var_count = 1;
+        if (parser->current_token.type != TOKEN_PIPE) break;
+        parser_eat(parser, TOKEN_PIPE);
+    }
+    free(fields);
+    
+    if (parser->current_token.type == TOKEN_SEMICOLON) {
+        parser_eat(parser, TOKEN_SEMICOLON);
+    }
+}
+
+CoreExpr *parse_core_lazy_body(const CoreLazyBody *lazy) {
+    Lexer lexer = lexer_create_with_length(lazy->text, lazy->length);
+    lexer_seek(&lexer, lazy->offset);
+    Parser parser = parser_create(lexer);
+    parser.lazy_lambdas = 1;
+    
+    CoreExpr *body = parse_core_expression(&parser);
+    if (parser.current_token.offset != lazy->end) {
+        parser_error(&parser, "Unexpected token in Core expression: %s",
+                     token_type_to_string(parser.current_token.type));
+    }
+    lexer_destroy(&parser.lexer);
+    return body;
+}
+
+// Every identifier in the body is a variable except lambda parameters,
+// let-bound names and the constructors and variables of patterns. The
+// body of a nested lambda whose parameter is `var` is skipped, as that
+// parameter shadows it.
+static int core_scan_mentions(Parser *parser, size_t end, Symbol var) {
+    int found = 0;
+    while (!found && parser->current_token.type != TOKEN_EOF && parser->current_token.offset < end) {
+        Token token = parser->current_token;
+        parser_advance(parser);
+        switch (token.type) {
+            case TOKEN_IDENTIFIER:
+                found = token.symbol == var;
+                break;
+            case TOKEN_KEYWORD_LET:
+                if (parser->current_token.type == TOKEN_IDENTIFIER) parser_advance(parser);
+                break;
+            case TOKEN_KEYWORD_OF:
+            case TOKEN_PIPE:
+            case TOKEN_SEMICOLON:
+                if (parser->current_token.type == TOKEN_IDENTIFIER) core_skip_alt_pattern(parser);
+                break;
+            case TOKEN_BACKSLASH: {
+                if (parser->current_token.type != TOKEN_IDENTIFIER) break;
+                Symbol param = parser->current_token.symbol;
+                parser_advance(parser);
+                if (param == var && parser->current_token.type == TOKEN_DOT) {
+                    parser_advance(parser);
+                    core_skip_lambda_body(parser);
+                }
+                break;
+            }
+            default:
+                break;
         }
-        
-        alts[alt_count++] = core_alt_create_con(constructor, vars, var_count, result);
-        
-        // Check for pipe or semicolon and second alternative
-        if (parser->current_token.type == TOKEN_PIPE || parser->current_token.type == TOKEN_SEMICOLON) {
-            TokenType separator = parser->current_token.type;
-            parser_eat(parser, separator);
-            
-            if (parser->current_token.type == TOKEN_IDENTIFIER) {
-                char *constructor2 = strdup(parser->current_token.text);
-                parser_eat(parser, TOKEN_IDENTIFIER);
-                parser_eat(parser, TOKEN_ARROW);
-                CoreExpr *result2 = parse_core_expression(parser);
-                
-                alts[alt_count++] = core_alt_create_con(constructor2, NULL, 0, result2);
+    }
+    return found;
+}
+
+int parse_core_lazy_mentions(const CoreLazyBody *lazy, const TokenBuffer *tokens, Symbol var) {
+    if (tokens) {
+        // The body's first token, found by its offset
+        size_t low = 0, high = tokens->count - 1;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (tokens->offsets[middle] < lazy->offset) {
+                low = middle + 1;
+            } else {
+                high = middle;
             }
         }
+        Parser parser = parser_create_from_tokens((TokenBuffer *)tokens);
+        parser.token_index = low;
+        parser.current_token = token_buffer_get(tokens, low);
+        return core_scan_mentions(&parser, lazy->end, var);
     }
     
-    return core_expr_create_case(expr, NULL, NULL, alts, alt_count);
-}
\ No newline at end of file
+    Lexer lexer = lexer_create_with_length(lazy->text, lazy->length);
+    lexer_seek(&lexer, lazy->offset);
+    Parser parser = parser_create(lexer);
+    int found = core_scan_mentions(&parser, lazy->end, var);
+    lexer_destroy(&parser.lexer);
+    return found;
+}
@@ -1,7 +1,10 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include <setjmp.h>
 #include "lexer.h"
+#include "token_buffer.h"
+#include "arena.h"
 
 typedef enum
 {
@@ -84,7 +87,7 @@ typedef struct CoreType
 
 typedef struct CoreVar
 {
-    char *name;             // Variable name
+    Symbol name;            // Interned variable name
     CoreType *type;         // Variable type (optional for now)
     enum {
         VAR_LOCAL,          // Local variable
@@ -102,7 +105,7 @@ typedef struct CoreLit
         LIT_CHAR            // Character literals
     } lit_kind;
     union {
-        int int_val;
+        int64_t int_val;
         double double_val;
         char *string_val;
         char char_val;
@@ -124,8 +127,9 @@ typedef struct CoreAlt
     } alt_kind;
     union {
         struct {
-            char *constructor;      // Constructor name
-            CoreVar **vars;         // Bound variables
+            Symbol constructor;     // Interned constructor name
+            int id;                 // core_constructor_id(constructor)
+            CoreVar **vars;         // Bound variables, one per field
             int var_count;
         } con;
         CoreLit *lit;              // Literal pattern
@@ -133,6 +137,16 @@ typedef struct CoreAlt
     struct CoreExpr *expr;         // Alternative expression
 } CoreAlt;
 
+// Jump table from constructor id to the first alternative matching it,
+// built when a case expression is created
+typedef struct CoreCaseTable
+{
+    int base;               // Id of alt_index[0]
+    int count;              // Number of ids covered
+    int default_alt;        // Index of the '_' alternative, or -1
+    int alt_index[];        // Alternative for id base + i, or -1
+} CoreCaseTable;
+
 typedef struct CoreExpr
 {
     CoreExprType expr_type;
@@ -145,7 +159,9 @@ typedef struct CoreExpr
         } app;
         struct {                   // CORE_LAM
             CoreVar *var;
-            struct CoreExpr *body;
+            struct CoreExpr *body; // Use core_lam_body, as this is NULL while lazy
+            struct CoreLazyBody *lazy;     // Body not parsed yet, or NULL
+            struct CoreLazySubst *pending; // Substitutions into the lazy body
         } lam;
         struct {                   // CORE_LET
             CoreBind **binds;      // Array of bindings
@@ -159,6 +175,7 @@ typedef struct CoreExpr
             CoreType *type;        // Result type
             CoreAlt **alts;        // Alternatives
             int alt_count;
+            struct CoreCaseTable *table; // Alternative for each constructor id
         } case_expr;
         struct {                   // CORE_CAST
             struct CoreExpr *expr;
@@ -185,20 +202,51 @@ CoreExpr *core_expr_create_lam(CoreVar *var, CoreExpr *body);
 CoreExpr *core_expr_create_let(CoreBind **binds, int bind_count, CoreExpr *body, int is_recursive);
 CoreExpr *core_expr_create_case(CoreExpr *expr, CoreVar *var, CoreType *type, CoreAlt **alts, int alt_count);
 
-CoreVar *core_var_create(char *name, CoreType *type, int var_kind);
-CoreLit *core_lit_create_int(int val);
+CoreVar *core_var_create(const char *name, CoreType *type, int var_kind);
+CoreVar *core_var_create_symbol(Symbol name, CoreType *type, int var_kind);
+CoreLit *core_lit_create_int(int64_t val);
 CoreLit *core_lit_create_double(double val);
 CoreLit *core_lit_create_string(char *val);
+CoreLit *core_lit_create_string_n(const char *val, size_t length);
 CoreBind *core_bind_create(CoreVar *var, CoreExpr *expr);
-CoreAlt *core_alt_create_con(char *constructor, CoreVar **vars, int var_count, CoreExpr *expr);
+CoreAlt *core_alt_create_con(const char *constructor, CoreVar **vars, int var_count, CoreExpr *expr);
+CoreAlt *core_alt_create_con_symbol(Symbol constructor, CoreVar **vars, int var_count, CoreExpr *expr);
 CoreAlt *core_alt_create_default(CoreExpr *expr);
 
-void core_expr_free(CoreExpr *expr);
-void core_type_free(CoreType *type);
-void core_var_free(CoreVar *var);
-void core_lit_free(CoreLit *lit);
-void core_bind_free(CoreBind *bind);
-void core_alt_free(CoreAlt *alt);
+// Lazy lambda bodies. While Parser.lazy_lambdas is set,
+// parse_core_expression only finds where each lambda body ends and
+// records its extent; core_lam_body parses it the first time the body is
+// needed, so functions that are never called are never built.
+typedef struct CoreLazyBody
+{
+    const char *text;       // Whole program text, which must outlive the tree
+    size_t length;
+    size_t offset;          // Offset of the body's first token
+    size_t end;             // Offset of the token after the body
+    Arena *arena;           // Arena the body is parsed into
+    struct CoreExpr *body;  // Parsed body, once needed
+} CoreLazyBody;
+
+CoreExpr *core_expr_create_lazy_lam(CoreVar *var, CoreLazyBody *lazy);
+CoreExpr *core_lam_body(CoreExpr *lam);
+
+// Core nodes are allocated from the current thread's arena and freed
+// only by releasing it. core_arena_swap makes `arena` current and returns
+// the previous one; with none set a per-thread default arena is used.
+Arena *core_arena_swap(Arena *arena);
+Arena *core_arena(void);
+void *core_alloc(size_t size);
+
+// Optional hash-consing. While a share table is current, the builders
+// above (except core_expr_create_case and the alternatives) return an
+// existing node for a structurally identical subtree instead of a new
+// one, so equal subtrees are the same pointer. Shared nodes must never
+// be modified. The table remembers nodes of the current arena: swap it
+// out before switching arenas or rolling the arena back.
+typedef struct CoreShareTable CoreShareTable;
+CoreShareTable *core_share_create(void);
+void core_share_free(CoreShareTable *table);
+CoreShareTable *core_share_swap(CoreShareTable *table);
 
 void core_expr_print(CoreExpr *expr, int indent);
 const char *core_expr_type_to_string(CoreExprType type);
@@ -278,15 +326,42 @@ typedef struct ASTNode
     };
 } ASTNode;
 
+// Most tokens parser_peek can see past the current one when pulling from a lexer
+#define PARSER_MAX_LOOKAHEAD 4
+
+// A parser reads tokens either straight from a lexer or from a TokenBuffer
+// lexed up front. In buffered mode any token can be inspected with
+// parser_peek, and because the Parser is a small value, saving a copy and
+// restoring it later backtracks without re-lexing. In streaming mode the
+// lexer cannot be rewound, so peeked tokens are queued in `lookahead`.
 typedef struct
 {
     Lexer lexer;
     Token current_token;
+    TokenBuffer *tokens;       // Pre-lexed tokens, or NULL to pull from lexer
+    size_t token_index;        // Index of current_token in tokens
+    Token lookahead[PARSER_MAX_LOOKAHEAD]; // Tokens lexed by parser_peek, next first
+    size_t lookahead_count;
+    int lazy_lambdas;          // Leave lambda bodies unparsed (see CoreLazyBody)
 } Parser;
 
 Parser parser_create(Lexer lexer);
+Parser parser_create_from_tokens(TokenBuffer *tokens);
+void parser_advance(Parser *parser);
+Token parser_peek(Parser *parser, size_t ahead);
 void parser_eat(Parser *parser, TokenType token_type);
 
+// Line and column of the current token
+SourcePosition parser_position(Parser *parser);
+// Print "Error: <message> at line L, column C" for the current token and exit
+_Noreturn void parser_error(Parser *parser, const char *format, ...);
+// While a thread has a trap set, parser_error on that thread longjmps to
+// it instead, without printing anything. The working buffers of every
+// parse in progress on the thread are freed first, so set the trap
+// outside any parse; Core nodes already built stay in their arena.
+// Returns the previous trap.
+jmp_buf *parser_trap_errors(jmp_buf *trap);
+
 Type *parse_type(Parser *parser);
 Type *parse_atomic_type(Parser *parser);
 void free_type(Type *type);
@@ -318,10 +393,14 @@ void print_ast(ASTNode *node, int indent);
 
 // Core parsing functions (Phase 2)
 CoreExpr *parse_core_expression(Parser *parser);
-CoreExpr *parse_core_atom(Parser *parser);
-CoreExpr *parse_core_application(Parser *parser);
-CoreExpr *parse_core_lambda(Parser *parser);
-CoreExpr *parse_core_let(Parser *parser);
-CoreExpr *parse_core_case(Parser *parser);
+void parse_core_type_declaration(Parser *parser);
+
+// Parse a lazy lambda body into the current arena, exiting with an error
+// if it does not end where the pre-parse found it to end
+CoreExpr *parse_core_lazy_body(const CoreLazyBody *lazy);
+// Whether the parsed body would mention `var`, as core_expr_contains_var
+// sees it, found by scanning its tokens: in `tokens` if the body was
+// parsed from that buffer, else by lexing its text again
+int parse_core_lazy_mentions(const CoreLazyBody *lazy, const TokenBuffer *tokens, Symbol var);
 
 #endif // PARSER_H
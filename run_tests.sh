@@ -14,8 +14,16 @@ for test_file in tests/*.lang; do
     expected_output="tests/$test_name.out"
     actual_output="tests/$test_name.actual"
 
-    # Run the test
-    $LANG_EXEC < "$test_file" > "$actual_output" 2>&1
+    # Run the test: through its script (given LANG_EXEC and TEST_FILE) if
+    # there is tests/NAME.sh, on the file with the options in tests/NAME.args
+    # if there is one, and from stdin otherwise
+    if [ -f "tests/$test_name.sh" ]; then
+        LANG_EXEC=$LANG_EXEC TEST_FILE=$test_file bash "tests/$test_name.sh" > "$actual_output" 2>&1
+    elif [ -f "tests/$test_name.args" ]; then
+        $LANG_EXEC $(cat "tests/$test_name.args") "$test_file" > "$actual_output" 2>&1
+    else
+        $LANG_EXEC < "$test_file" > "$actual_output" 2>&1
+    fi
 
     # Compare the actual output to the expected output
     if diff -q "$expected_output" "$actual_output" > /dev/null; then
@@ -0,0 +1,164 @@
+#include "scan.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SCAN_WIDTH 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SCAN_WIDTH 16
+#endif
+
+static inline int is_space_byte(unsigned char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+#if defined(__AVX2__)
+
+typedef __m256i scan_vec;
+
+static inline scan_vec scan_load(const char *p)
+{
+    return _mm256_loadu_si256((const __m256i *)p);
+}
+
+static inline scan_vec scan_splat(char c)
+{
+    return _mm256_set1_epi8(c);
+}
+
+static inline scan_vec scan_eq(scan_vec a, scan_vec b)
+{
+    return _mm256_cmpeq_epi8(a, b);
+}
+
+static inline scan_vec scan_or(scan_vec a, scan_vec b)
+{
+    return _mm256_or_si256(a, b);
+}
+
+// Lanes where (unsigned)(x - lo) <= span, i.e. lo <= x <= lo + span
+static inline scan_vec scan_in_range(scan_vec x, char lo, char span)
+{
+    scan_vec shifted = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(span)), shifted);
+}
+
+static inline unsigned scan_mask(scan_vec v)
+{
+    return (unsigned)_mm256_movemask_epi8(v);
+}
+
+#elif defined(__SSE2__)
+
+typedef __m128i scan_vec;
+
+static inline scan_vec scan_load(const char *p)
+{
+    return _mm_loadu_si128((const __m128i *)p);
+}
+
+static inline scan_vec scan_splat(char c)
+{
+    return _mm_set1_epi8(c);
+}
+
+static inline scan_vec scan_eq(scan_vec a, scan_vec b)
+{
+    return _mm_cmpeq_epi8(a, b);
+}
+
+static inline scan_vec scan_or(scan_vec a, scan_vec b)
+{
+    return _mm_or_si128(a, b);
+}
+
+// Lanes where (unsigned)(x - lo) <= span, i.e. lo <= x <= lo + span
+static inline scan_vec scan_in_range(scan_vec x, char lo, char span)
+{
+    scan_vec shifted = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(span)), shifted);
+}
+
+static inline unsigned scan_mask(scan_vec v)
+{
+    return (unsigned)_mm_movemask_epi8(v);
+}
+
+#endif
+
+const char *scan_find_byte(const char *p, const char *end, char c)
+{
+#ifdef SCAN_WIDTH
+    scan_vec needle = scan_splat(c);
+    while (end - p >= SCAN_WIDTH)
+    {
+        unsigned mask = scan_mask(scan_eq(scan_load(p), needle));
+        if (mask)
+        {
+            return p + __builtin_ctz(mask);
+        }
+        p += SCAN_WIDTH;
+    }
+#endif
+    while (p < end && *p != c)
+    {
+        p++;
+    }
+    return p;
+}
+
+const char *scan_find_either(const char *p, const char *end, char a, char b)
+{
+#ifdef SCAN_WIDTH
+    scan_vec needle_a = scan_splat(a);
+    scan_vec needle_b = scan_splat(b);
+    while (end - p >= SCAN_WIDTH)
+    {
+        scan_vec chunk = scan_load(p);
+        unsigned mask = scan_mask(scan_or(scan_eq(chunk, needle_a), scan_eq(chunk, needle_b)));
+        if (mask)
+        {
+            return p + __builtin_ctz(mask);
+        }
+        p += SCAN_WIDTH;
+    }
+#endif
+    while (p < end && *p != a && *p != b)
+    {
+        p++;
+    }
+    return p;
+}
+
+const char *scan_skip_space(const char *p, const char *end)
+{
+    // Most whitespace runs are a single space; check before vectorizing
+    if (p < end && !is_space_byte((unsigned char)*p))
+    {
+        return p;
+    }
+#ifdef SCAN_WIDTH
+    scan_vec blank = scan_splat(' ');
+    while (end - p >= SCAN_WIDTH)
+    {
+        scan_vec chunk = scan_load(p);
+        // '\t' through '\r' are the contiguous range 0x09-0x0D
+        unsigned space = scan_mask(scan_or(scan_eq(chunk, blank), scan_in_range(chunk, '\t', '\r' - '\t')));
+        unsigned other = ~space;
+#if SCAN_WIDTH == 16
+        other &= 0xFFFF;
+#endif
+        if (other)
+        {
+            return p + __builtin_ctz(other);
+        }
+        p += SCAN_WIDTH;
+    }
+#endif
+    while (p < end && is_space_byte((unsigned char)*p))
+    {
+        p++;
+    }
+    return p;
+}
@@ -0,0 +1,24 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <stddef.h>
+
+// Byte scanning primitives used by the lexer's skip loops.
+// Each function examines [p, end) and returns a pointer to the first
+// matching byte, or `end` if there is none. They never read at or past
+// `end`, so they are safe on buffers that are not NUL-terminated.
+//
+// With SSE2 (always available on x86-64) or AVX2 (when compiled with
+// -mavx2 or -march=native) they compare 16 or 32 bytes per step; other
+// targets use a scalar loop.
+
+// First byte equal to `c`
+const char *scan_find_byte(const char *p, const char *end, char c);
+
+// First byte equal to `a` or `b`
+const char *scan_find_either(const char *p, const char *end, char a, char b);
+
+// First byte that is not ' ', '\t', '\n', '\v', '\f' or '\r'
+const char *scan_skip_space(const char *p, const char *end);
+
+#endif // SCAN_H
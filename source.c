@@ -0,0 +1,64 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "source.h"
+
+int source_open(Source *source, const char *filename)
+{
+    source->text = NULL;
+    source->length = 0;
+    source->mapping = NULL;
+    source->stream = fopen(filename, "r");
+    if (!source->stream)
+    {
+        return 0;
+    }
+
+    struct stat info;
+    if (fstat(fileno(source->stream), &info) != 0 || !S_ISREG(info.st_mode) || (uintmax_t)info.st_size > SIZE_MAX)
+    {
+        return 1; // Not a mappable file; read it as a stream
+    }
+
+    size_t length = (size_t)info.st_size;
+    if (length == 0)
+    {
+        // mmap rejects empty mappings
+        source->text = "";
+    }
+    else
+    {
+        void *mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fileno(source->stream), 0);
+        if (mapping == MAP_FAILED)
+        {
+            return 1; // Fall back to streaming
+        }
+        // The lexer reads the program front to back exactly once
+        posix_madvise(mapping, length, POSIX_MADV_SEQUENTIAL);
+        source->mapping = mapping;
+        source->text = mapping;
+    }
+    source->length = length;
+
+    // The mapping stays valid after the file is closed
+    fclose(source->stream);
+    source->stream = NULL;
+    return 1;
+}
+
+void source_close(Source *source)
+{
+    if (source->mapping)
+    {
+        munmap(source->mapping, source->length);
+        source->mapping = NULL;
+    }
+    if (source->stream)
+    {
+        fclose(source->stream);
+        source->stream = NULL;
+    }
+    source->text = NULL;
+    source->length = 0;
+}
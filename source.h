@@ -0,0 +1,26 @@
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Program source loading
+// ======================
+// A regular file is mapped read-only and lexed in place, so it is never
+// copied into the heap and its pages are shared through the page cache
+// with other processes reading the same file. Anything that cannot be
+// mapped (pipes, FIFOs, character devices) is left open as a stream for
+// lexer_create_stream instead.
+typedef struct
+{
+    const char *text; // Whole program when mapped, NULL when streaming
+    size_t length;    // Length of text in bytes
+    void *mapping;    // Region to unmap (NULL for an empty file)
+    FILE *stream;     // Open file to stream from, or NULL when mapped
+} Source;
+
+// Returns 0 if the file cannot be opened
+int source_open(Source *source, const char *filename);
+void source_close(Source *source);
+
+#endif // SOURCE_H
@@ -24,7 +24,7 @@ SymbolTable *symbol_table_create()
 }
 
 // Add a constructor to the symbol table
-void symbol_table_add(SymbolTable *table, const char *constructor_name, const char *adt_type_name)
+void symbol_table_add(SymbolTable *table, Symbol constructor_name, Symbol adt_type_name)
 {
     if (table->count >= table->capacity)
     {
@@ -36,22 +36,22 @@ void symbol_table_add(SymbolTable *table, const char *constructor_name, const ch
             exit(EXIT_FAILURE);
         }
     }
-    table->entries[table->count].constructor_name = strdup(constructor_name);
-    table->entries[table->count].adt_type_name = strdup(adt_type_name);
+    table->entries[table->count].constructor_name = constructor_name;
+    table->entries[table->count].adt_type_name = adt_type_name;
     table->count++;
 }
 
 // Lookup a constructor in the symbol table
-const char *symbol_table_lookup(SymbolTable *table, const char *constructor_name)
+Symbol symbol_table_lookup(SymbolTable *table, Symbol constructor_name)
 {
     for (int i = 0; i < table->count; i++)
     {
-        if (strcmp(table->entries[i].constructor_name, constructor_name) == 0)
+        if (table->entries[i].constructor_name == constructor_name)
         {
             return table->entries[i].adt_type_name;
         }
     }
-    return NULL; // Not found
+    return SYMBOL_NONE; // Not found
 }
 
 // Free the symbol table
@@ -59,11 +59,6 @@ void symbol_table_free(SymbolTable *table)
 {
     if (!table)
         return;
-    for (int i = 0; i < table->count; i++)
-    {
-        free(table->entries[i].constructor_name);
-        free(table->entries[i].adt_type_name);
-    }
     free(table->entries);
     free(table);
 }
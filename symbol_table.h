@@ -2,12 +2,13 @@
 #define SYMBOL_TABLE_H
 
 #include "parser.h"
+#include "intern.h"
 
 // Structure to hold constructor entries
 typedef struct
 {
-    char *constructor_name;
-    char *adt_type_name;
+    Symbol constructor_name;
+    Symbol adt_type_name;
 } ConstructorEntry;
 
 // Symbol table structure
@@ -20,8 +21,9 @@ typedef struct
 
 // Function prototypes
 SymbolTable *symbol_table_create();
-void symbol_table_add(SymbolTable *table, const char *constructor_name, const char *adt_type_name);
-const char *symbol_table_lookup(SymbolTable *table, const char *constructor_name);
+void symbol_table_add(SymbolTable *table, Symbol constructor_name, Symbol adt_type_name);
+// Returns the ADT type of a constructor, or SYMBOL_NONE if it is unknown
+Symbol symbol_table_lookup(SymbolTable *table, Symbol constructor_name);
 void symbol_table_free(SymbolTable *table);
 
 #endif // SYMBOL_TABLE_H
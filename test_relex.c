@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "token_buffer.h"
+
+// Incremental re-lexing check
+// ===========================
+// Applies edits to a program and checks after each one that
+// token_buffer_relex leaves the buffer exactly as lexer_tokenize leaves a
+// buffer lexed from the edited text. A fixed list covers edits at token
+// boundaries that change how the text around them lexes; then
+// RANDOM_EDITS random insertions and deletions of token fragments are
+// applied to a generated program. Exits non-zero on the first mismatch.
+
+#define RANDOM_EDITS 30000
+#define RANDOM_SEED 12345
+#define PROGRAM_SIZE 4096
+
+// Each pair is a text before and after an edit; the edit is what lies
+// between their common prefix and suffix
+static const struct
+{
+    const char *before;
+    const char *after;
+} boundary_cases[] = {
+    {"let x = a in x", "let x = ab in x"},         // Extends the token ending at the edit
+    {"let x = ab in x", "let x = a in x"},         // Shortens it
+    {"f - 1", "f -- 1"},                           // '-' becomes a line comment
+    {"f - 1\ng", "f -- 1\ng"},                     // ... that ends at the newline
+    {"f - 1", "f -> 1"},                           // '-' becomes '->'
+    {"f -> 1", "f - 1"},                           // and back
+    {"f -- 1\ng", "f - 1\ng"},                     // A line comment becomes '-'
+    {"a b c d", "a {- b c d"},                     // Opens a comment running to the end
+    {"a b -} c d", "a {- b -} c d"},               // Opens a comment closed later
+    {"a {- b -} c d", "a {- b c d"},               // Removes the close of a comment
+    {"a {- b c d", "a {- b -} c d"},               // Closes a comment
+    {"a {- b {- c -} d -} e", "a {- b {- c d -} e"}, // Unbalances a nested comment
+    {"a {- b -} c", "a { b -} c"},                 // Turns an opening into '{'
+    {"f 12 x", "f 12.5 x"},                        // Extends a number with a fraction
+    {"f 12.5 x", "f 12 x"},                        // Drops the fraction
+    {"f 1 . x", "f 1. x"},                         // Joins '.' to a number
+    {"f 1 5", "f 1.5"},                            // Joins two numbers
+    {"f \"ab\" x", "f \"a b\" x"},                 // Edits inside a string
+    {"f \"ab\" x", "f \"ab\"x"},                   // Edits right after a string
+    {"let x = 1 in x", "let x = 1 in xy"},         // Appends at EOF
+    {"f -", "f ->"},                               // Extends the last token at EOF
+    {"f 1", "f 1."},                               // Extends a number at EOF
+    {"f x", "f x {-"},                             // Opens a comment at EOF
+    {"f x -- c", "f x"},                           // Deletes a comment at EOF
+    {"a", ""},                                     // Deletes everything
+    {"", "a"},                                     // Inserts into nothing
+};
+
+// Pieces inserted by the random edits. String quotes are left out, as an
+// edit that leaves one unterminated is a lexing error; edits that join
+// digits and points into a malformed number are skipped for the same
+// reason.
+static const char *fragments[] = {
+    "-", ">", "=", "{-", "-}", "--", "{", "}", ".", "5", "12", "3.25", "x", "y1",
+    "in", "let", "case", " ", "  ", "\n", "(", ")", "\\", "|", ";", ",", "->", "=>", "<=",
+};
+
+static const char *snippet =
+    "{- block {- nested -} comment -}\n"
+    "let add = \\ x . \\ y . (+) x y in -- curried addition\n"
+    "let total = add 40 2.5 in\n"
+    "case (==) total 42 of True -> 1 ; False -> (-) total 1.5\n";
+
+static char *text_alloc(size_t size)
+{
+    char *text = malloc(size + 1);
+    if (!text)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for relex check\n");
+        exit(EXIT_FAILURE);
+    }
+    return text;
+}
+
+static TokenBuffer *tokenize(const char *text, size_t length)
+{
+    Lexer lexer = lexer_create_with_length(text, length);
+    return lexer_tokenize(&lexer);
+}
+
+// Whether some run of digits and points has more than one point, which the
+// lexer rejects as a number (conservatively, even inside comments)
+static int has_malformed_number(const char *text, size_t length)
+{
+    int points = 0, digits = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        if (text[i] == '.')
+        {
+            points++;
+        }
+        else if (text[i] >= '0' && text[i] <= '9')
+        {
+            digits++;
+        }
+        else
+        {
+            points = digits = 0;
+        }
+        if (points > 1 && digits > 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Returns the index of the first token that differs, or -1
+static long first_difference(const TokenBuffer *a, const TokenBuffer *b)
+{
+    size_t count = a->count < b->count ? a->count : b->count;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (a->types[i] != b->types[i] || a->offsets[i] != b->offsets[i] || a->lengths[i] != b->lengths[i])
+        {
+            return (long)i;
+        }
+        if ((a->types[i] == TOKEN_IDENTIFIER && a->values[i].symbol != b->values[i].symbol) ||
+            (a->types[i] == TOKEN_INTEGER && a->values[i].integer != b->values[i].integer) ||
+            (a->types[i] == TOKEN_NUMBER && a->values[i].number != b->values[i].number))
+        {
+            return (long)i;
+        }
+    }
+    return a->count == b->count ? -1 : (long)count;
+}
+
+// Apply `edit` to `buffer`, lexed from `before`, and compare the result
+// with lexing `after` from scratch. Returns 0 on a mismatch.
+static int check_edit(TokenBuffer *buffer, const char *before, const char *after, size_t after_length,
+                      TextEdit edit, const char *label)
+{
+    token_buffer_relex(buffer, after, after_length, edit);
+    TokenBuffer *expected = tokenize(after, after_length);
+    long index = first_difference(buffer, expected);
+    if (index >= 0)
+    {
+        fprintf(stderr, "FAIL %s: edit at %zu deleting %zu and inserting %zu bytes\n", label, edit.offset,
+                edit.deleted_length, edit.inserted_length);
+        fprintf(stderr, "  before: \"%s\"\n  after:  \"%s\"\n", before, after);
+        fprintf(stderr, "  token %ld differs (%zu tokens, %zu expected)\n", index, buffer->count,
+                expected->count);
+    }
+    token_buffer_free(expected);
+    return index < 0;
+}
+
+static int check_boundary_cases(void)
+{
+    int passed = 1;
+    for (size_t i = 0; i < sizeof(boundary_cases) / sizeof(boundary_cases[0]); i++)
+    {
+        const char *before = boundary_cases[i].before;
+        const char *after = boundary_cases[i].after;
+        size_t before_length = strlen(before), after_length = strlen(after);
+        size_t shorter = before_length < after_length ? before_length : after_length;
+
+        size_t prefix = 0;
+        while (prefix < shorter && before[prefix] == after[prefix])
+        {
+            prefix++;
+        }
+        size_t suffix = 0;
+        while (prefix + suffix < shorter &&
+               before[before_length - suffix - 1] == after[after_length - suffix - 1])
+        {
+            suffix++;
+        }
+        TextEdit edit = {prefix, before_length - prefix - suffix, after_length - prefix - suffix};
+
+        TokenBuffer *buffer = tokenize(before, before_length);
+        char label[32];
+        snprintf(label, sizeof(label), "boundary case %zu", i + 1);
+        passed &= check_edit(buffer, before, after, after_length, edit, label);
+        token_buffer_free(buffer);
+    }
+    return passed;
+}
+
+static int check_random_edits(void)
+{
+    size_t snippet_length = strlen(snippet);
+    size_t length = 0;
+    char *text = text_alloc(PROGRAM_SIZE);
+    while (length + snippet_length <= PROGRAM_SIZE)
+    {
+        memcpy(text + length, snippet, snippet_length);
+        length += snippet_length;
+    }
+    text[length] = '\0';
+
+    TokenBuffer *buffer = tokenize(text, length);
+    srand(RANDOM_SEED);
+    int passed = 1;
+    for (int i = 0; i < RANDOM_EDITS && passed; i++)
+    {
+        size_t offset = (size_t)rand() % (length + 1);
+        // Delete more while the text is longer than it started, so its
+        // length stays around PROGRAM_SIZE
+        size_t deleted = (size_t)rand() % (length > PROGRAM_SIZE ? 9 : 3);
+        if (deleted > length - offset)
+        {
+            deleted = length - offset;
+        }
+        // Insert nothing a third of the time, to get pure deletions
+        const char *inserted = rand() % 3 == 0 ? "" : fragments[rand() % (sizeof(fragments) / sizeof(fragments[0]))];
+        size_t inserted_length = strlen(inserted);
+
+        size_t edited_length = length - deleted + inserted_length;
+        char *edited = text_alloc(edited_length);
+        memcpy(edited, text, offset);
+        memcpy(edited + offset, inserted, inserted_length);
+        memcpy(edited + offset + inserted_length, text + offset + deleted, length - offset - deleted);
+        edited[edited_length] = '\0';
+        if (has_malformed_number(edited, edited_length))
+        {
+            free(edited);
+            continue;
+        }
+
+        char label[32];
+        snprintf(label, sizeof(label), "random edit %d", i + 1);
+        passed = check_edit(buffer, text, edited, edited_length, (TextEdit){offset, deleted, inserted_length},
+                            label);
+        free(text);
+        text = edited;
+        length = edited_length;
+    }
+
+    token_buffer_free(buffer);
+    free(text);
+    return passed;
+}
+
+int main(void)
+{
+    int passed = check_boundary_cases();
+    passed &= check_random_edits();
+    printf("Relex check: %s\n", passed ? "PASS" : "FAIL");
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
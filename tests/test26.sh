@@ -0,0 +1,7 @@
+#!/bin/bash
+# Compile the program to a cache, then run the cache
+cache=$(mktemp "${TMPDIR:-/tmp}/test26.XXXXXX")
+$LANG_EXEC --compile --output "$cache" "$TEST_FILE" && $LANG_EXEC "$cache"
+status=$?
+rm -f "$cache"
+exit $status
@@ -0,0 +1,23 @@
+#!/bin/bash
+# Generate bindings f1 .. f40 in front of the test program, so it is large
+# enough to parse in parallel, then run it with -j 4 and compare the trees
+# -j 4 and -j 1 build through their caches
+dir=$(mktemp -d "${TMPDIR:-/tmp}/test30.XXXXXX")
+awk 'BEGIN {
+    for (f = 1; f <= 40; f++) {
+        printf "let f%d = \\ v . case v of\n", f
+        for (k = 1; k <= 2000; k++) printf "  %s K%d -> %d\n", k == 1 ? " " : "|", k, k
+        printf "  | _ -> 0\nin\n"
+    }
+}' > "$dir/program.lang"
+cat "$TEST_FILE" >> "$dir/program.lang"
+
+$LANG_EXEC -j 4 "$dir/program.lang"
+$LANG_EXEC -j 4 --compile --output "$dir/parallel.langc" "$dir/program.lang"
+$LANG_EXEC -j 1 --compile --output "$dir/serial.langc" "$dir/program.lang"
+if cmp -s "$dir/parallel.langc" "$dir/serial.langc"; then
+    echo "same cache"
+else
+    echo "caches differ"
+fi
+rm -rf "$dir"
@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "token_buffer.h"
+
+#define TOKEN_BUFFER_INITIAL_CAPACITY 256
+
+static void *token_buffer_resize(void *array, size_t capacity, size_t element_size)
+{
+    void *resized = realloc(array, capacity * element_size);
+    if (!resized)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for token buffer\n");
+        exit(EXIT_FAILURE);
+    }
+    return resized;
+}
+
+static void token_buffer_grow(TokenBuffer *buffer, size_t capacity)
+{
+    buffer->types = token_buffer_resize(buffer->types, capacity, sizeof(uint8_t));
+    buffer->offsets = token_buffer_resize(buffer->offsets, capacity, sizeof(uint32_t));
+    buffer->lengths = token_buffer_resize(buffer->lengths, capacity, sizeof(uint32_t));
+    buffer->values = token_buffer_resize(buffer->values, capacity, sizeof(TokenValue));
+    buffer->capacity = capacity;
+}
+
+TokenBuffer *token_buffer_create(const char *source, size_t source_length)
+{
+    TokenBuffer *buffer = malloc(sizeof(TokenBuffer));
+    if (!buffer)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for token buffer\n");
+        exit(EXIT_FAILURE);
+    }
+    buffer->types = NULL;
+    buffer->offsets = NULL;
+    buffer->lengths = NULL;
+    buffer->values = NULL;
+    buffer->count = 0;
+    buffer->capacity = 0;
+    buffer->source = source;
+    buffer->source_length = source_length;
+    buffer->lines = NULL;
+    token_buffer_grow(buffer, TOKEN_BUFFER_INITIAL_CAPACITY);
+    return buffer;
+}
+
+void token_buffer_reserve(TokenBuffer *buffer, size_t capacity)
+{
+    if (capacity > buffer->capacity)
+    {
+        token_buffer_grow(buffer, capacity);
+    }
+}
+
+void token_buffer_push(TokenBuffer *buffer, Token token)
+{
+    if (buffer->count == buffer->capacity)
+    {
+        token_buffer_grow(buffer, buffer->capacity * 2);
+    }
+    size_t i = buffer->count++;
+    buffer->types[i] = (uint8_t)token.type;
+    buffer->offsets[i] = (uint32_t)(token.text - buffer->source);
+    buffer->lengths[i] = (uint32_t)token.length;
+    switch (token.type)
+    {
+    case TOKEN_IDENTIFIER:
+        buffer->values[i].symbol = token.symbol;
+        break;
+    case TOKEN_INTEGER:
+        buffer->values[i].integer = token.integer;
+        break;
+    default:
+        buffer->values[i].number = token.value;
+        break;
+    }
+}
+
+Token token_buffer_get(const TokenBuffer *buffer, size_t index)
+{
+    // Reading past the end keeps returning the final TOKEN_EOF
+    if (index >= buffer->count)
+    {
+        index = buffer->count - 1;
+    }
+    Token token;
+    token.type = (TokenType)buffer->types[index];
+    switch (token.type)
+    {
+    case TOKEN_IDENTIFIER:
+        token.symbol = buffer->values[index].symbol;
+        break;
+    case TOKEN_INTEGER:
+        token.integer = buffer->values[index].integer;
+        break;
+    default:
+        token.value = buffer->values[index].number;
+        break;
+    }
+    token.text = buffer->source + buffer->offsets[index];
+    token.length = buffer->lengths[index];
+    token.offset = buffer->offsets[index] - (token.type == TOKEN_STRING);
+    return token;
+}
+
+void token_buffer_free(TokenBuffer *buffer)
+{
+    if (!buffer)
+        return;
+    free(buffer->types);
+    free(buffer->offsets);
+    free(buffer->lengths);
+    free(buffer->values);
+    line_index_free(buffer->lines);
+    free(buffer);
+}
+
+SourcePosition token_buffer_position(TokenBuffer *buffer, size_t offset)
+{
+    if (!buffer->lines)
+    {
+        buffer->lines = line_index_build(buffer->source, buffer->source_length);
+    }
+    return line_index_lookup(buffer->lines, offset);
+}
+
+TokenBuffer *lexer_tokenize(Lexer *lexer)
+{
+    if (lexer->buffer)
+    {
+        // Offsets would refer to a chunk that is overwritten as lexing goes on
+        fprintf(stderr, "Error: Cannot tokenize a streaming lexer into a token buffer\n");
+        exit(EXIT_FAILURE);
+    }
+    if (lexer->length > UINT32_MAX)
+    {
+        fprintf(stderr, "Error: Source text too large to tokenize (%zu bytes)\n", lexer->length);
+        exit(EXIT_FAILURE);
+    }
+
+    TokenBuffer *buffer = token_buffer_create(lexer->text, lexer->length);
+    Token token;
+    do
+    {
+        token = lexer_get_next_token(lexer);
+        token_buffer_push(buffer, token);
+    } while (token.type != TOKEN_EOF);
+    return buffer;
+}
+
+// ============================================================================
+// Incremental re-lexing
+// ============================================================================
+
+// Where token `index` begins and ends in the source. A string token's text
+// excludes its quotes, but the lexer consumed them.
+static size_t token_buffer_start(const TokenBuffer *buffer, size_t index)
+{
+    return buffer->offsets[index] - (buffer->types[index] == TOKEN_STRING);
+}
+
+static size_t token_buffer_end(const TokenBuffer *buffer, size_t index)
+{
+    return buffer->offsets[index] + buffer->lengths[index] + (buffer->types[index] == TOKEN_STRING);
+}
+
+size_t token_buffer_relex(TokenBuffer *buffer, const char *source, size_t length, TextEdit edit)
+{
+    if (length > UINT32_MAX)
+    {
+        fprintf(stderr, "Error: Source text too large to tokenize (%zu bytes)\n", length);
+        exit(EXIT_FAILURE);
+    }
+
+    size_t old_edit_end = edit.offset + edit.deleted_length;
+    size_t new_edit_end = edit.offset + edit.inserted_length;
+
+    // Keep every token that ends before the edit. The lexer looks one byte
+    // past the end of a token (to end an identifier, or to tell '-' from
+    // '->'), so a token ending right at the edit is re-lexed as well. Between
+    // tokens the lexer is never inside a comment, so it can restart at the
+    // end of the last kept token whatever comments follow it.
+    size_t low = 0, high = buffer->count - 1; // The final TOKEN_EOF is never kept
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if (token_buffer_end(buffer, mid) < edit.offset)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    size_t keep = low;
+    size_t restart = keep > 0 ? token_buffer_end(buffer, keep - 1) : 0;
+
+    // First old token that starts after the edited text; earlier ones can
+    // never line up again
+    size_t old_index = keep;
+    while (old_index < buffer->count && token_buffer_start(buffer, old_index) < old_edit_end)
+    {
+        old_index++;
+    }
+
+    // Lex until a fresh token starts exactly where an old token (shifted by
+    // the edit) started. The text from there on is unchanged and the lexer
+    // state at a token start is always the same, so every remaining old
+    // token would be lexed again unchanged. Comments that the edit opens or
+    // closes are rescanned as a whole, because a resync point is never
+    // inside one.
+    TokenBuffer *fresh = token_buffer_create(source, length);
+    Lexer lexer = lexer_create_with_length(source, length);
+    lexer_seek(&lexer, restart);
+    int resynced = 0;
+    for (;;)
+    {
+        Token token = lexer_get_next_token(&lexer);
+        size_t start = (size_t)(token.text - source) - (token.type == TOKEN_STRING);
+        if (start >= new_edit_end)
+        {
+            while (old_index < buffer->count &&
+                   token_buffer_start(buffer, old_index) - old_edit_end + new_edit_end < start)
+            {
+                old_index++;
+            }
+            if (old_index < buffer->count &&
+                token_buffer_start(buffer, old_index) - old_edit_end + new_edit_end == start)
+            {
+                resynced = 1;
+                break;
+            }
+        }
+        token_buffer_push(fresh, token);
+        if (token.type == TOKEN_EOF)
+        {
+            break;
+        }
+    }
+
+    // Splice: kept tokens, then the fresh ones, then the old tail moved by
+    // the change in length
+    size_t tail = resynced ? buffer->count - old_index : 0;
+    size_t count = keep + fresh->count + tail;
+    token_buffer_reserve(buffer, count);
+    size_t to = keep + fresh->count;
+    memmove(buffer->types + to, buffer->types + old_index, tail * sizeof(uint8_t));
+    memmove(buffer->offsets + to, buffer->offsets + old_index, tail * sizeof(uint32_t));
+    memmove(buffer->lengths + to, buffer->lengths + old_index, tail * sizeof(uint32_t));
+    memmove(buffer->values + to, buffer->values + old_index, tail * sizeof(TokenValue));
+    for (size_t i = to; i < count; i++)
+    {
+        buffer->offsets[i] = (uint32_t)(buffer->offsets[i] + edit.inserted_length - edit.deleted_length);
+    }
+    memcpy(buffer->types + keep, fresh->types, fresh->count * sizeof(uint8_t));
+    memcpy(buffer->offsets + keep, fresh->offsets, fresh->count * sizeof(uint32_t));
+    memcpy(buffer->lengths + keep, fresh->lengths, fresh->count * sizeof(uint32_t));
+    memcpy(buffer->values + keep, fresh->values, fresh->count * sizeof(TokenValue));
+    buffer->count = count;
+    buffer->source = source;
+    buffer->source_length = length;
+    line_index_free(buffer->lines); // Line starts moved with the edit
+    buffer->lines = NULL;
+
+    size_t relexed = fresh->count;
+    token_buffer_free(fresh);
+    return relexed;
+}
@@ -0,0 +1,61 @@
+#ifndef TOKEN_BUFFER_H
+#define TOKEN_BUFFER_H
+
+#include <stdint.h>
+#include "lexer.h"
+
+// A whole program lexed up front, stored as parallel arrays (struct of
+// arrays) so the parser walks dense memory and can look at any token by
+// index. Token i is described by types[i], offsets[i], lengths[i] and
+// values[i]; offsets and lengths locate its text within `source`.
+// The last token is always TOKEN_EOF.
+typedef union
+{
+    double number;   // Value of a TOKEN_NUMBER
+    int64_t integer; // Value of a TOKEN_INTEGER
+    Symbol symbol;   // Interned name of a TOKEN_IDENTIFIER
+} TokenValue;
+
+typedef struct
+{
+    uint8_t *types;     // TokenType of each token
+    uint32_t *offsets;  // Byte offset of each token's text in source
+    uint32_t *lengths;  // Byte length of each token's text
+    TokenValue *values; // Number or symbol carried by each token
+    size_t count;       // Number of tokens, including the final TOKEN_EOF
+    size_t capacity;    // Allocated length of each array
+    const char *source; // Text the offsets refer to (not owned)
+    size_t source_length;
+    LineIndex *lines; // Line starts of source, built on first use
+} TokenBuffer;
+
+TokenBuffer *token_buffer_create(const char *source, size_t source_length);
+void token_buffer_push(TokenBuffer *buffer, Token token);
+// Make room for at least `capacity` tokens
+void token_buffer_reserve(TokenBuffer *buffer, size_t capacity);
+Token token_buffer_get(const TokenBuffer *buffer, size_t index);
+void token_buffer_free(TokenBuffer *buffer);
+
+// Line and column of byte `offset` in the source (e.g. Token.offset)
+SourcePosition token_buffer_position(TokenBuffer *buffer, size_t offset);
+
+// Lex everything remaining in `lexer` into a new buffer
+TokenBuffer *lexer_tokenize(Lexer *lexer);
+
+// An edit that replaced deleted_length bytes at offset with
+// inserted_length new bytes
+typedef struct
+{
+    size_t offset;
+    size_t deleted_length;
+    size_t inserted_length;
+} TextEdit;
+
+// Bring `buffer`, lexed from the text before `edit`, up to date with
+// source[0..length), the text after it. Only tokens from just before the
+// edit up to the first token that lines up with an old one again are
+// lexed; the rest are moved. Afterwards the buffer refers to `source`.
+// Returns the number of tokens lexed.
+size_t token_buffer_relex(TokenBuffer *buffer, const char *source, size_t length, TextEdit edit);
+
+#endif // TOKEN_BUFFER_H